@@ -3,6 +3,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include "eeprom_cancellation.hpp"
+#include "eeprom_config.hpp"
+#include "eeprom_operation_listener.hpp"
 #include "spi_bit_banging_helper.hpp"
 
 /**
@@ -41,13 +44,70 @@ public:
      */
     static constexpr std::size_t PAGE_SIZE = 16;
 
+    /**
+     * @brief Описание битового поля для пакетного чтения/записи.
+     */
+    struct BitField
+    {
+        std::size_t address; ///< Адрес байта, с которого начинается поле
+        unsigned bitOffset;  ///< Смещение в битах от младшего бита address (может быть больше 7)
+        unsigned bitCount;   ///< Ширина поля в битах (1..32)
+    };
+
+    /**
+     * @brief Размер кадра чтения в операциях с отменой.
+     */
+    static constexpr std::size_t CANCEL_CHUNK = 4 * PAGE_SIZE;
+
+    /**
+     * @brief Максимальное количество наблюдателей за операциями.
+     */
+    static constexpr std::size_t MAX_LISTENERS = EEPROM_MAX_LISTENERS;
+
+    /**
+     * @brief Размер буфера readFields()/writeFields() в байтах.
+     */
+    static constexpr std::size_t MAX_FIELD_SPAN = EEPROM_MAX_FIELD_SPAN;
+
+    /**
+     * @brief Счётчики обращений к шине.
+     */
+    using BusStatistics = EEPROMBusStatistics;
+
     /**
      * @brief Конструктор.
      *
      * @param spi_helper Helper для передачи байтов по SPI.
      */
     explicit EEPROM25LC040A(SPIBitBangingHelper &spi_helper)
-        : spi_(spi_helper) {}
+        : spi_(spi_helper), listeners_{}, depth_(0), bus_{} {}
+
+    /**
+     * @brief Накопленные счётчики обращений к шине.
+     *
+     * Наблюдатели получают стоимость операции через EEPROMOperationMeter.
+     */
+    const BusStatistics &busStatistics() const { return bus_; }
+
+    /**
+     * @brief Сбросить счётчики обращений к шине.
+     */
+    void resetBusStatistics() { bus_ = BusStatistics{}; }
+
+    /**
+     * @brief Добавить наблюдателя за операциями.
+     *
+     * @param listener Наблюдатель.
+     * @return false, если свободных слотов нет.
+     */
+    bool addListener(EEPROMOperationListener *listener);
+
+    /**
+     * @brief Удалить наблюдателя.
+     *
+     * @param listener Наблюдатель, добавленный через addListener().
+     */
+    void removeListener(EEPROMOperationListener *listener);
 
     /**
      * @brief Прочитать один байт из EEPROM.
@@ -87,6 +147,117 @@ public:
      */
     void writeArray(std::size_t address, const uint8_t *buffer, std::size_t length);
 
+    /**
+     * @brief Записать массив байт с возможностью отмены.
+     *
+     * Признак отмены проверяется перед каждой страницей: запись
+     * останавливается после завершения текущей страницы (включая tWC).
+     *
+     * @param address Начальный адрес.
+     * @param buffer  Буфер источника (данные).
+     * @param length  Количество байт для записи.
+     * @param token   Признак отмены.
+     * @return Сколько байт записано и была ли операция отменена.
+     */
+    OperationProgress writeArray(std::size_t address,
+                                 const uint8_t *buffer,
+                                 std::size_t length,
+                                 const CancellationToken &token);
+
+    /**
+     * @brief Прочитать массив байт с возможностью отмены.
+     *
+     * Чтение выполняется кадрами по CANCEL_CHUNK байт,
+     * признак отмены проверяется между кадрами.
+     *
+     * @param address Начальный адрес.
+     * @param buffer  Буфер назначения.
+     * @param length  Количество байт для чтения.
+     * @param token   Признак отмены.
+     * @return Сколько байт прочитано и была ли операция отменена.
+     */
+    OperationProgress readArray(std::size_t address,
+                                uint8_t *buffer,
+                                std::size_t length,
+                                const CancellationToken &token) const;
+
+    /**
+     * @brief Сравнить содержимое EEPROM с ожидаемыми данными.
+     *
+     * Чтение выполняется кадрами по CANCEL_CHUNK байт без буфера
+     * на весь массив; при первом расхождении проверка прекращается.
+     *
+     * @param address  Начальный адрес.
+     * @param expected Ожидаемые данные.
+     * @param length   Количество байт.
+     * @param token    Признак отмены (nullptr - без отмены).
+     * @param progress Если не nullptr - сколько байт совпало и была ли отмена.
+     * @return true, если все байты совпали и проверка не отменена.
+     */
+    bool verifyArray(std::size_t address,
+                     const uint8_t *expected,
+                     std::size_t length,
+                     const CancellationToken *token = nullptr,
+                     OperationProgress *progress = nullptr) const;
+
+    /**
+     * @brief Скопировать диапазон из одной микросхемы в другую.
+     *
+     * Копирование идёт страницами приёмника с конвейером: пока приёмник
+     * выполняет внутреннюю запись страницы (tWC), из источника читается
+     * следующая страница. Время копирования определяется циклами записи
+     * приёмника, а не суммой чтения и записи.
+     *
+     * Микросхемы должны иметь отдельные линии CS. Если источник и приёмник -
+     * одна и та же микросхема, конвейер невозможен (во время tWC чтение
+     * запрещено) и страницы копируются последовательно. Перекрывающиеся
+     * диапазоны копируются как memmove: если приёмник выше источника,
+     * страницы копируются с конца, и completed при отмене - число
+     * скопированных байт в конце диапазона.
+     *
+     * @param source             Микросхема-источник.
+     * @param sourceAddress      Начальный адрес в источнике.
+     * @param destination        Микросхема-приёмник.
+     * @param destinationAddress Начальный адрес в приёмнике.
+     * @param length             Количество байт.
+     * @param token              Признак отмены (nullptr - без отмены),
+     *                           проверяется перед каждой страницей.
+     * @return Сколько байт записано в приёмник и была ли отмена.
+     */
+    static OperationProgress copyBetween(const EEPROM25LC040A &source,
+                                         std::size_t sourceAddress,
+                                         EEPROM25LC040A &destination,
+                                         std::size_t destinationAddress,
+                                         std::size_t length,
+                                         const CancellationToken *token = nullptr);
+
+    /**
+     * @brief Записать одинаковые данные сразу в несколько микросхем.
+     *
+     * Микросхемы должны разделять линии SCLK и MOSI и отличаться только CS.
+     * Кадры WREN и WRITE передаются один раз при одновременно опущенных CS
+     * всех микросхем, поэтому страница программируется во всех микросхемах
+     * за одно и то же время tWC. Бит WIP затем проверяется у каждой
+     * микросхемы отдельно.
+     *
+     * Тактирование и MOSI формируются через helper первой микросхемы,
+     * драйверы остальных используются только для управления их CS
+     * и опроса регистра статуса. Каждая микросхема учитывает общие кадры
+     * в своих busStatistics() и сообщает своим наблюдателям об операции
+     * WRITE_ARRAY. На хосте общую шину моделирует EEPROM25LC040ASharedBus.
+     *
+     * @param chips   Массив указателей на микросхемы.
+     * @param count   Количество микросхем.
+     * @param address Начальный адрес.
+     * @param buffer  Буфер источника (данные).
+     * @param length  Количество байт для записи.
+     */
+    static void broadcastWriteArray(EEPROM25LC040A *const *chips,
+                                    std::size_t count,
+                                    std::size_t address,
+                                    const uint8_t *buffer,
+                                    std::size_t length);
+
     /**
      * @brief Прочитать один байт.
      *
@@ -135,6 +306,46 @@ public:
                    unsigned bitCount,
                    uint32_t value);
 
+    /**
+     * @brief Прочитать несколько битовых полей за одну транзакцию.
+     *
+     * Диапазон байт, покрывающий все поля, читается одним кадром READ,
+     * после чего поля извлекаются из 64-битных слов (BMI2 PEXT, если
+     * доступен, иначе сдвигом и маской). Если диапазон длиннее
+     * MAX_FIELD_SPAN, он читается окнами - по кадру на окно.
+     *
+     * Бит N поля - бит (bitOffset + N) от младшего бита байта address,
+     * с переходом в следующие байты. При bitOffset < 8 это совпадает
+     * с readBits(); большее смещение (поле начинается в одном из
+     * следующих байтов) readBits() не поддерживает. Некорректные поля
+     * (bitCount вне 1..32 или за концом микросхемы) читаются как 0.
+     *
+     * @param fields Массив описаний полей.
+     * @param count  Количество полей.
+     * @param values Массив результатов (count элементов).
+     */
+    void readFields(const BitField *fields,
+                    std::size_t count,
+                    uint32_t *values) const;
+
+    /**
+     * @brief Записать несколько битовых полей.
+     *
+     * Покрывающий диапазон читается одним кадром READ, поля вставляются
+     * в 64-битные слова (BMI2 PDEP, если доступен), после чего
+     * каждая страница с изменёнными байтами программируется один раз.
+     * Нумерация бит - как в readFields(); некорректные поля пропускаются.
+     * Диапазон длиннее MAX_FIELD_SPAN обрабатывается окнами, и страница
+     * на границе окон может программироваться дважды.
+     *
+     * @param fields Массив описаний полей.
+     * @param count  Количество полей.
+     * @param values Значения полей (используются младшие bitCount бит).
+     */
+    void writeFields(const BitField *fields,
+                     std::size_t count,
+                     const uint32_t *values);
+
 private:
     /**
      * @brief Команды SPI EEPROM.
@@ -152,6 +363,21 @@ private:
      */
     void writeEnable();
 
+    /**
+     * @brief Опустить CS (начать кадр).
+     */
+    void select() const;
+
+    /**
+     * @brief Поднять CS (закончить кадр).
+     */
+    void deselect() const;
+
+    /**
+     * @brief Передать байт в текущем кадре.
+     */
+    uint8_t transfer(uint8_t value) const;
+
     /**
      * @brief Прочитать регистр статуса.
      *
@@ -167,8 +393,59 @@ private:
      */
     void waitUntilWriteComplete() const;
 
+    /**
+     * @brief Начать запись страницы: WREN и кадр WRITE без ожидания tWC.
+     *
+     * Данные не должны пересекать границу страницы. Перед следующим
+     * обращением к микросхеме нужно вызвать waitUntilWriteComplete().
+     */
+    void beginPageWrite(std::size_t address, const uint8_t *data, std::size_t length);
+
+    /**
+     * @brief Постраничная запись массива.
+     *
+     * @param token Признак отмены (nullptr - без отмены).
+     */
+    OperationProgress writePages(std::size_t address,
+                                 const uint8_t *buffer,
+                                 std::size_t length,
+                                 const CancellationToken *token);
+
+    /**
+     * @brief Сообщить наблюдателям о начале операции (только внешней).
+     */
+    void beginOperation(const EEPROMOperationInfo &info) const;
+
+    /**
+     * @brief Сообщить наблюдателям о конце операции (только внешней).
+     */
+    void endOperation(const EEPROMOperationInfo &info) const;
+
+    /**
+     * @brief Сообщает наблюдателям о начале и конце внешней операции.
+     *
+     * Вложенные операции (глубина вызова больше 1) не сообщаются.
+     */
+    class OperationScope
+    {
+    public:
+        OperationScope(const EEPROM25LC040A &eeprom, const EEPROMOperationInfo &info);
+        ~OperationScope();
+
+        OperationScope(const OperationScope &) = delete;
+        OperationScope &operator=(const OperationScope &) = delete;
+
+    private:
+        const EEPROM25LC040A &eeprom_;
+        EEPROMOperationInfo info_;
+    };
+
 private:
     SPIBitBangingHelper &spi_;
+
+    EEPROMOperationListener *listeners_[MAX_LISTENERS];
+    mutable unsigned depth_; ///< Глубина вложенности публичных вызовов
+    mutable BusStatistics bus_;
 };
 
 #endif // EEPROM_25LC040A_HPP
@@ -0,0 +1,219 @@
+#ifndef EEPROM_25LC040A_SIMULATOR_HPP
+#define EEPROM_25LC040A_SIMULATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+#include "spi_bit_banging_driver.hpp"
+
+/**
+ * @file eeprom_25lc040a_simulator.hpp
+ * @brief Программная модель микросхемы 25LC040A на уровне линий SPI.
+ *
+ * Используется на хосте для воспроизведения трасс и оценки
+ * оптимизаций без аппаратуры.
+ */
+
+/**
+ * @brief Симулятор 25LC040A, подключаемый вместо GPIO-драйвера.
+ *
+ * Реализует SPIBitBangingDriver и моделирует протокол в том виде,
+ * в котором его использует EEPROM25LC040A: команды READ, WRITE,
+ * WREN, RDSR, адрес из двух байт, запись в пределах страницы
+ * с переходом на её начало, защёлку WEL и бит WIP на время tWC.
+ *
+ * Время моделируется: каждый такт SCLK добавляет clockPeriodNs,
+ * delay_us() — заданное время; WIP сбрасывается, когда с начала
+ * внутренней записи прошло writeCycleUs.
+ */
+class EEPROM25LC040ASimulator : public SPIBitBangingDriver
+{
+public:
+    /**
+     * @brief Счётчики обращений к модели.
+     */
+    struct Statistics
+    {
+        uint64_t clocks;      ///< Импульсы SCLK при опущенном CS
+        uint64_t frames;      ///< Кадры (опусканий CS)
+        uint64_t writeCycles; ///< Циклы внутренней записи (tWC)
+        uint64_t statusPolls; ///< Чтения регистра статуса
+        uint64_t delayUs;     ///< Время в delay_us()
+    };
+
+    /**
+     * @brief Конструктор.
+     *
+     * @param clockPeriodNs Период SCLK в наносекундах.
+     * @param writeCycleUs  Время внутренней записи tWC в микросекундах.
+     */
+    explicit EEPROM25LC040ASimulator(unsigned clockPeriodNs = 1000,
+                                     unsigned writeCycleUs = 5000);
+
+    void cs_low() override;
+    void cs_high() override;
+    void write_mosi(bool bit) override;
+    bool read_miso() override;
+    void pulse_clock() override;
+    void delay_us(unsigned us) override;
+
+    /**
+     * @brief Содержимое памяти модели.
+     */
+    uint8_t *memory() { return memory_; }
+    const uint8_t *memory() const { return memory_; }
+
+    /**
+     * @brief Модельное время с момента создания, нс.
+     */
+    uint64_t elapsedNs() const { return nowNs_; }
+
+    /**
+     * @brief Накопленные счётчики.
+     */
+    const Statistics &statistics() const { return stats_; }
+
+    /**
+     * @brief Сбросить счётчики (время и память не меняются).
+     */
+    void resetStatistics() { stats_ = Statistics{}; }
+
+    /**
+     * @brief Смоделировать пропадание питания.
+     *
+     * Следующие writeCycles циклов записи выполняются как обычно,
+     * из очередного цикла сохраняются только первые tornBytes байт
+     * данных кадра (страница прервана на середине), а дальнейшие
+     * команды WRITE не принимаются до restorePower().
+     *
+     * @param writeCycles Количество циклов записи до сбоя.
+     * @param tornBytes   Сколько байт прерванного цикла успевает записаться.
+     */
+    void cutPowerAfter(uint64_t writeCycles, std::size_t tornBytes = 0);
+
+    /**
+     * @brief Восстановить питание после cutPowerAfter().
+     */
+    void restorePower();
+
+    /**
+     * @brief Пропало ли питание (запись не принимается).
+     */
+    bool poweredOff() const { return poweredOff_; }
+
+private:
+    /**
+     * @brief Обработать принятый байт кадра.
+     */
+    void onByte(uint8_t byte);
+
+    /**
+     * @brief Идёт ли внутренняя запись.
+     */
+    bool busy() const { return nowNs_ < writeDoneNs_; }
+
+private:
+    static constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+
+    unsigned clockPeriodNs_;
+    unsigned writeCycleUs_;
+
+    uint8_t memory_[EEPROM25LC040A::CAPACITY_BYTES];
+    Statistics stats_;
+    uint64_t nowNs_;
+    uint64_t writeDoneNs_;
+
+    // Состояние линий и кадра
+    bool selected_;
+    bool mosi_;
+    bool miso_;
+    unsigned bitIndex_;   ///< Номер бита в текущем байте
+    std::size_t byteIndex_; ///< Номер байта в кадре
+    uint8_t shiftIn_;
+    uint8_t shiftOut_;
+    uint8_t opcode_;
+    std::size_t address_;
+    bool writeEnabled_; ///< Защёлка WEL
+
+    // Буфер страницы для команды WRITE
+    bool writeAccepted_;
+    uint8_t page_[PAGE];
+    bool pageMask_[PAGE];
+
+    // Модель пропадания питания
+    bool powerLossArmed_;
+    uint64_t cyclesBeforeLoss_;
+    std::size_t tornBytes_;
+    bool poweredOff_;
+};
+
+/**
+ * @brief Общие линии SCLK и MOSI нескольких симуляторов.
+ *
+ * Каждая микросхема подключается через свой порт - SPIBitBangingDriver
+ * для её EEPROM25LC040A. CS порта управляет только своей микросхемой,
+ * а MOSI, такты SCLK и задержки получают все микросхемы шины, поэтому
+ * модельное время у них общее. MISO порта - линия своей микросхемы
+ * (на общей шине её читают только при одном опущенном CS).
+ *
+ * Используется для проверки EEPROM25LC040A::broadcastWriteArray().
+ */
+class EEPROM25LC040ASharedBus
+{
+public:
+    /**
+     * @brief Максимальное количество микросхем на шине.
+     */
+    static constexpr std::size_t MAX_CHIPS = 8;
+
+    /**
+     * @brief Конструктор.
+     *
+     * @param chips Симуляторы микросхем.
+     * @param count Количество микросхем (не больше MAX_CHIPS, лишние не подключаются).
+     */
+    EEPROM25LC040ASharedBus(EEPROM25LC040ASimulator *const *chips, std::size_t count);
+
+    EEPROM25LC040ASharedBus(const EEPROM25LC040ASharedBus &) = delete;
+    EEPROM25LC040ASharedBus &operator=(const EEPROM25LC040ASharedBus &) = delete;
+
+    /**
+     * @brief Количество подключённых микросхем.
+     */
+    std::size_t size() const { return count_; }
+
+    /**
+     * @brief Порт микросхемы с номером index.
+     */
+    SPIBitBangingDriver &port(std::size_t index) { return ports_[index]; }
+
+private:
+    /**
+     * @brief Линии одной микросхемы на общей шине.
+     */
+    class Port : public SPIBitBangingDriver
+    {
+    public:
+        Port() : bus_(nullptr), chip_(nullptr) {}
+
+        void attach(EEPROM25LC040ASharedBus *bus, EEPROM25LC040ASimulator *chip);
+
+        void cs_low() override;
+        void cs_high() override;
+        void write_mosi(bool bit) override;
+        bool read_miso() override;
+        void pulse_clock() override;
+        void delay_us(unsigned us) override;
+
+    private:
+        EEPROM25LC040ASharedBus *bus_;
+        EEPROM25LC040ASimulator *chip_;
+    };
+
+private:
+    EEPROM25LC040ASimulator *chips_[MAX_CHIPS];
+    Port ports_[MAX_CHIPS];
+    std::size_t count_;
+};
+
+#endif // EEPROM_25LC040A_SIMULATOR_HPP
@@ -0,0 +1,132 @@
+#ifndef EEPROM_BITSTREAM_HPP
+#define EEPROM_BITSTREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file eeprom_bitstream.hpp
+ * @brief Битовые потоки в буфере RAM.
+ *
+ * Биты нумеруются так же, как в EEPROM25LC040A::readBits() и
+ * writeBits(): от младшего бита байта к старшему, значение
+ * укладывается начиная с младшего бита. Поэтому поле, записанное
+ * BitStreamWriter со смещением N бит от начала буфера, можно
+ * прочитать с микросхемы вызовом readBits(address + N / 8, N % 8, count).
+ */
+
+/**
+ * @brief Запись битового потока.
+ */
+class BitStreamWriter
+{
+public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param buffer   Буфер (неиспользуемые биты должны быть обнулены).
+     * @param capacity Размер буфера в битах.
+     * @param position Начальная позиция в битах.
+     */
+    BitStreamWriter(uint8_t *buffer, std::size_t capacity, std::size_t position = 0)
+        : buffer_(buffer), capacity_(capacity), position_(position)
+    {
+    }
+
+    /**
+     * @brief Записать младшие bitCount бит значения.
+     *
+     * @return false, если не хватает места (поток не меняется).
+     */
+    bool write(uint32_t value, unsigned bitCount)
+    {
+        if (bitCount > 32 || bitCount > capacity_ - position_)
+        {
+            return false;
+        }
+
+        for (unsigned i = 0; i < bitCount; ++i, ++position_)
+        {
+            const uint8_t mask = static_cast<uint8_t>(1u << (position_ % 8));
+            if ((value >> i) & 1u)
+            {
+                buffer_[position_ / 8] |= mask;
+            }
+            else
+            {
+                buffer_[position_ / 8] &= static_cast<uint8_t>(~mask);
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Текущая позиция в битах.
+     */
+    std::size_t position() const { return position_; }
+
+    /**
+     * @brief Сколько бит ещё помещается.
+     */
+    std::size_t remaining() const { return capacity_ - position_; }
+
+private:
+    uint8_t *buffer_;
+    std::size_t capacity_;
+    std::size_t position_;
+};
+
+/**
+ * @brief Чтение битового потока.
+ */
+class BitStreamReader
+{
+public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param buffer   Буфер.
+     * @param capacity Размер буфера в битах.
+     * @param position Начальная позиция в битах.
+     */
+    BitStreamReader(const uint8_t *buffer, std::size_t capacity, std::size_t position = 0)
+        : buffer_(buffer), capacity_(capacity), position_(position)
+    {
+    }
+
+    /**
+     * @brief Прочитать bitCount бит.
+     *
+     * @param value Результат (младшие bitCount бит).
+     * @return false, если поток закончился (позиция не меняется).
+     */
+    bool read(uint32_t &value, unsigned bitCount)
+    {
+        if (bitCount > 32 || bitCount > capacity_ - position_)
+        {
+            return false;
+        }
+
+        value = 0;
+        for (unsigned i = 0; i < bitCount; ++i, ++position_)
+        {
+            const uint32_t bit = (buffer_[position_ / 8] >> (position_ % 8)) & 1u;
+            value |= bit << i;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Текущая позиция в битах.
+     */
+    std::size_t position() const { return position_; }
+
+private:
+    const uint8_t *buffer_;
+    std::size_t capacity_;
+    std::size_t position_;
+};
+
+#endif // EEPROM_BITSTREAM_HPP
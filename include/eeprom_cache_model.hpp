@@ -0,0 +1,133 @@
+#ifndef EEPROM_CACHE_MODEL_HPP
+#define EEPROM_CACHE_MODEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_trace.hpp"
+
+/**
+ * @file eeprom_cache_model.hpp
+ * @brief Модель политик кеширования EEPROM, управляемая трассами.
+ *
+ * Инструмент для хоста: прогоняет трассу операций через модель
+ * кеша заданной конфигурации и считает обращения к шине, циклы
+ * записи и модельное время, не обращаясь к микросхеме.
+ */
+
+/**
+ * @brief Конфигурация моделируемого кеша.
+ */
+struct EEPROMCacheConfig
+{
+    /**
+     * @brief Политика кеширования.
+     */
+    enum class Policy : uint8_t
+    {
+        NONE,        ///< Без кеша - как прямые вызовы EEPROM25LC040A
+        FULL_MIRROR, ///< Полное зеркало (EEPROMShadow), загрузка одним кадром
+        LRU          ///< lruPages страниц, вытеснение давно не использованных
+    };
+
+    Policy policy;              ///< Политика
+    std::size_t lruPages;       ///< Размер LRU-кеша в страницах
+    std::size_t readaheadPages; ///< Сколько страниц дочитывать после промаха
+    uint32_t flushIntervalUs;   ///< Период сброса изменений (0 - сквозная запись)
+    unsigned clockPeriodNs;     ///< Период SCLK
+    unsigned writeCycleUs;      ///< Время внутренней записи tWC
+};
+
+/**
+ * @brief Результат прогона трассы.
+ */
+struct EEPROMCacheReport
+{
+    uint64_t operations;      ///< Операции трассы
+    uint64_t busTransactions; ///< Кадры READ и WRITE
+    uint64_t busBytes;        ///< Байт передано по шине (с командами и адресами)
+    uint64_t writeCycles;     ///< Программирования страниц (tWC)
+    uint64_t cacheHits;       ///< Страницы, найденные в кеше
+    uint64_t cacheMisses;     ///< Страницы, прочитанные с микросхемы
+    uint64_t busTimeUs;       ///< Модельное время занятости шины и tWC, всего
+    uint64_t foregroundUs;    ///< Часть времени, потраченная внутри вызовов API
+};
+
+/**
+ * @brief Модель кеша над EEPROM 25LC040A.
+ *
+ * Запись выделяет страницу в кеше без чтения (write-allocate).
+ * Изменённый участок страницы сбрасывается одной записью от первого
+ * до последнего изменённого байта; если между ними есть байты,
+ * которые не записывались, а страница не была прочитана,
+ * перед сбросом моделируется чтение страницы (промах кеша).
+ */
+class EEPROMCacheModel
+{
+public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param config Конфигурация кеша.
+     */
+    explicit EEPROMCacheModel(const EEPROMCacheConfig &config);
+
+    /**
+     * @brief Прогнать трассу и вернуть отчёт.
+     *
+     * В конце трассы оставшиеся изменения сбрасываются
+     * и учитываются в отчёте.
+     */
+    EEPROMCacheReport run(EEPROMTraceReader &reader);
+
+private:
+    static constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+    static constexpr std::size_t PAGE_COUNT = EEPROM25LC040A::CAPACITY_BYTES / PAGE;
+
+    static_assert(PAGE <= 32, "маска изменённых байтов должна помещаться в uint32_t");
+
+    /**
+     * @brief Состояние страницы в кеше.
+     */
+    struct PageState
+    {
+        bool present;          ///< Страница занимает место в кеше
+        bool valid;            ///< Содержимое страницы прочитано с микросхемы
+        bool dirty;            ///< Есть несохранённые изменения
+        std::size_t dirtyFrom; ///< Первый изменённый байт (смещение в странице)
+        std::size_t dirtyTo;   ///< Последний изменённый байт
+        uint32_t dirtyMask;    ///< Изменённые байты (бит на байт страницы)
+        uint64_t lastUse;      ///< Для LRU
+    };
+
+    void reset();
+    void apply(const EEPROMTraceRecord &record);
+
+    // Стоимость операций на шине; foreground - внутри вызова API
+    void chargeRead(std::size_t length, bool foreground);
+    void chargeWrite(std::size_t length, bool foreground);
+    void charge(uint64_t ns, bool foreground);
+
+    // Прямой доступ (политика NONE) так, как его выполняет драйвер
+    void directRead(std::size_t address, std::size_t length);
+    void directWrite(std::size_t address, std::size_t length);
+
+    // Доступ через кеш
+    void cachedRead(std::size_t address, std::size_t length);
+    void cachedWrite(std::size_t address, std::size_t length);
+    void touch(std::size_t page);
+    void makeRoom(std::size_t page);
+    void flushPage(std::size_t page, bool foreground);
+    void flushAll(bool foreground);
+
+private:
+    EEPROMCacheConfig config_;
+    EEPROMCacheReport report_;
+    PageState pages_[PAGE_COUNT];
+    uint64_t useCounter_;
+    uint64_t lastFlushUs_;
+    uint64_t busNs_;
+    uint64_t foregroundNs_;
+};
+
+#endif // EEPROM_CACHE_MODEL_HPP
@@ -0,0 +1,53 @@
+#ifndef EEPROM_CANCELLATION_HPP
+#define EEPROM_CANCELLATION_HPP
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @file eeprom_cancellation.hpp
+ * @brief Отмена длительных операций EEPROM.
+ *
+ * Длительные операции (запись и проверка больших массивов) проверяют
+ * признак отмены между кадрами SPI и останавливаются на ближайшей
+ * согласованной границе: страница либо записана целиком, либо не начата.
+ */
+
+/**
+ * @brief Признак отмены операции.
+ *
+ * cancel() можно вызывать из другого потока или обработчика прерывания.
+ */
+class CancellationToken
+{
+public:
+    /**
+     * @brief Запросить отмену.
+     */
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Сбросить признак для повторного использования.
+     */
+    void reset() { cancelled_.store(false, std::memory_order_relaxed); }
+
+    /**
+     * @brief Запрошена ли отмена.
+     */
+    bool isCancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled_{false};
+};
+
+/**
+ * @brief Результат длительной операции.
+ */
+struct OperationProgress
+{
+    std::size_t completed; ///< Обработано байт (целыми кадрами)
+    std::size_t total;     ///< Запрошено байт
+    bool cancelled;        ///< Операция остановлена по отмене
+};
+
+#endif // EEPROM_CANCELLATION_HPP
@@ -0,0 +1,62 @@
+#ifndef EEPROM_CHECKSUM_HPP
+#define EEPROM_CHECKSUM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file eeprom_checksum.hpp
+ * @brief Контрольные суммы для проверки целостности данных EEPROM.
+ */
+
+/**
+ * @brief Вычислить CRC-32 (IEEE 802.3, полином 0xEDB88320).
+ *
+ * Поддерживает вычисление по частям: результат предыдущего вызова
+ * передаётся в previous.
+ *
+ * @param data     Данные.
+ * @param length   Количество байт.
+ * @param previous CRC предыдущего фрагмента (0 для первого).
+ * @return Значение CRC-32.
+ */
+inline uint32_t crc32(const uint8_t *data, std::size_t length, uint32_t previous = 0)
+{
+    uint32_t crc = ~previous;
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+
+    return ~crc;
+}
+
+/**
+ * @brief Вычислить CRC-8 (полином 0x07, начальное значение 0).
+ *
+ * @param data   Данные.
+ * @param length Количество байт.
+ * @return Значение CRC-8.
+ */
+inline uint8_t crc8(const uint8_t *data, std::size_t length)
+{
+    uint8_t crc = 0;
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = static_cast<uint8_t>((crc & 0x80u) ? (crc << 1) ^ 0x07u : crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+#endif // EEPROM_CHECKSUM_HPP
@@ -0,0 +1,145 @@
+#ifndef EEPROM_COMPRESSION_HPP
+#define EEPROM_COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+
+/**
+ * @file eeprom_compression.hpp
+ * @brief Сжатие записей EEPROM (LZSS с ограниченным окном).
+ *
+ * Формат потока: управляющий байт на каждые 8 элементов (бит 0 -
+ * первый элемент, 1 - литерал, 0 - ссылка), затем элементы:
+ *  - литерал: 1 байт;
+ *  - ссылка: байт (смещение - 1) и байт (длина - LZ_MIN_MATCH).
+ *
+ * Окно - LZ_WINDOW байт, поэтому декодеру не нужна память сверх
+ * буфера результата, а сжатие выполняется без выделения памяти.
+ *
+ * Формат записи в EEPROM: заголовок из LZ_RECORD_HEADER байт
+ * [метод, длина исходных данных (2 байта), длина сохранённых
+ * данных (2 байта), CRC-8 байтов 0..4], затем данные. Если сжатие
+ * не уменьшает размер, данные сохраняются как есть.
+ */
+
+/**
+ * @brief Размер окна сжатия (максимальное смещение ссылки).
+ */
+constexpr std::size_t LZ_WINDOW = 256;
+
+/**
+ * @brief Минимальная длина ссылки.
+ */
+constexpr std::size_t LZ_MIN_MATCH = 3;
+
+/**
+ * @brief Максимальная длина ссылки.
+ */
+constexpr std::size_t LZ_MAX_MATCH = LZ_MIN_MATCH + 255;
+
+/**
+ * @brief Размер заголовка сжатой записи.
+ */
+constexpr std::size_t LZ_RECORD_HEADER = 6;
+
+/**
+ * @brief Сжать данные.
+ *
+ * @param input    Исходные данные.
+ * @param length   Количество байт.
+ * @param output   Буфер результата.
+ * @param capacity Размер буфера результата.
+ * @return Размер сжатых данных; 0, если результат не помещается в буфер.
+ */
+std::size_t lzCompress(const uint8_t *input,
+                       std::size_t length,
+                       uint8_t *output,
+                       std::size_t capacity);
+
+/**
+ * @brief Потоковый декодер LZSS.
+ *
+ * Принимает сжатый поток частями произвольного размера (например,
+ * кадрами readArray) и пишет результат в буфер вызывающего.
+ */
+class LzDecoder
+{
+public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param output   Буфер результата.
+     * @param capacity Ожидаемый размер результата; декодирование
+     *                 прекращается, когда он достигнут.
+     */
+    LzDecoder(uint8_t *output, std::size_t capacity);
+
+    /**
+     * @brief Передать очередную часть сжатого потока.
+     *
+     * @return false при ошибке в потоке (ссылка за пределы
+     *         результата или переполнение буфера).
+     */
+    bool feed(const uint8_t *data, std::size_t length);
+
+    /**
+     * @brief Сколько байт уже декодировано.
+     */
+    std::size_t size() const { return size_; }
+
+    /**
+     * @brief Декодирован ли весь результат.
+     */
+    bool done() const { return size_ == capacity_; }
+
+    /**
+     * @brief Была ли ошибка в потоке.
+     */
+    bool failed() const { return failed_; }
+
+private:
+    uint8_t *output_;
+    std::size_t capacity_;
+    std::size_t size_;
+    uint8_t flags_;
+    unsigned flagsLeft_;
+    std::size_t offset_; ///< Смещение ссылки, 0 - не принято
+    bool failed_;
+};
+
+/**
+ * @brief Записать запись в EEPROM, по возможности сжав её.
+ *
+ * @param eeprom   Микросхема.
+ * @param address  Адрес записи.
+ * @param data     Данные.
+ * @param length   Размер данных (не больше CAPACITY_BYTES).
+ * @param capacity Место, отведённое под запись, включая заголовок.
+ * @return Сколько байт занято в EEPROM; 0, если запись не помещается.
+ */
+std::size_t writeCompressedRecord(EEPROM25LC040A &eeprom,
+                                  std::size_t address,
+                                  const uint8_t *data,
+                                  std::size_t length,
+                                  std::size_t capacity);
+
+/**
+ * @brief Прочитать запись, сохранённую writeCompressedRecord().
+ *
+ * Сжатые данные читаются кадрами и декодируются по мере чтения,
+ * без промежуточного буфера на всю запись.
+ *
+ * @param eeprom   Микросхема.
+ * @param address  Адрес записи.
+ * @param data     Буфер результата.
+ * @param capacity Размер буфера.
+ * @return Размер исходных данных; 0, если запись повреждена
+ *         или не помещается в буфер.
+ */
+std::size_t readCompressedRecord(const EEPROM25LC040A &eeprom,
+                                 std::size_t address,
+                                 uint8_t *data,
+                                 std::size_t capacity);
+
+#endif // EEPROM_COMPRESSION_HPP
@@ -0,0 +1,64 @@
+#ifndef EEPROM_CONFIG_HPP
+#define EEPROM_CONFIG_HPP
+
+/**
+ * @file eeprom_config.hpp
+ * @brief Ёмкости статических структур драйвера, задаваемые при сборке.
+ *
+ * Все структуры драйвера (наблюдатели, подписки, группы барьеров,
+ * слоты очередей) размещаются в массивах фиксированного размера,
+ * динамическая память не используется. Размеры можно переопределить
+ * через -D при сборке (в CMake - одноимёнными переменными кеша);
+ * недопустимые значения отсекаются static_assert.
+ */
+
+/**
+ * @brief Максимальное количество наблюдателей у одной микросхемы.
+ */
+#ifndef EEPROM_MAX_LISTENERS
+#define EEPROM_MAX_LISTENERS 4
+#endif
+
+/**
+ * @brief Размер буфера readFields()/writeFields() в байтах.
+ *
+ * Поля, покрывающий диапазон которых длиннее, обрабатываются окнами
+ * по кадру READ на окно.
+ */
+#ifndef EEPROM_MAX_FIELD_SPAN
+#define EEPROM_MAX_FIELD_SPAN 64
+#endif
+
+/**
+ * @brief Максимальное количество подписок на изменения в EEPROMShadow.
+ */
+#ifndef EEPROM_SHADOW_MAX_SUBSCRIPTIONS
+#define EEPROM_SHADOW_MAX_SUBSCRIPTIONS 8
+#endif
+
+/**
+ * @brief Максимальное количество групп между барьерами в EEPROMShadow.
+ */
+#ifndef EEPROM_SHADOW_MAX_BARRIERS
+#define EEPROM_SHADOW_MAX_BARRIERS 8
+#endif
+
+/**
+ * @brief Максимальное количество мест вызова в EEPROMCallSiteProfiler.
+ */
+#ifndef EEPROM_PROFILER_MAX_SITES
+#define EEPROM_PROFILER_MAX_SITES 32
+#endif
+
+static_assert(EEPROM_MAX_LISTENERS >= 1 && EEPROM_MAX_LISTENERS <= 16,
+              "EEPROM_MAX_LISTENERS должен быть в диапазоне [1, 16]");
+static_assert(EEPROM_MAX_FIELD_SPAN >= 8 && EEPROM_MAX_FIELD_SPAN <= 512,
+              "EEPROM_MAX_FIELD_SPAN должен быть в диапазоне [8, 512]");
+static_assert(EEPROM_SHADOW_MAX_SUBSCRIPTIONS >= 1 && EEPROM_SHADOW_MAX_SUBSCRIPTIONS <= 64,
+              "EEPROM_SHADOW_MAX_SUBSCRIPTIONS должен быть в диапазоне [1, 64]");
+static_assert(EEPROM_SHADOW_MAX_BARRIERS >= 1 && EEPROM_SHADOW_MAX_BARRIERS <= 32,
+              "EEPROM_SHADOW_MAX_BARRIERS должен быть в диапазоне [1, 32]");
+static_assert(EEPROM_PROFILER_MAX_SITES >= 1 && EEPROM_PROFILER_MAX_SITES <= 256,
+              "EEPROM_PROFILER_MAX_SITES должен быть в диапазоне [1, 256]");
+
+#endif // EEPROM_CONFIG_HPP
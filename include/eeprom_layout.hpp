@@ -0,0 +1,36 @@
+#ifndef EEPROM_LAYOUT_HPP
+#define EEPROM_LAYOUT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file eeprom_layout.hpp
+ * @brief Описание размещения полей данных в EEPROM.
+ *
+ * Используется оптимизатором размещения и механизмом миграции
+ * между версиями раскладки.
+ */
+
+/**
+ * @brief Размещение одного поля в памяти.
+ */
+struct FieldPlacement
+{
+    uint16_t id;         ///< Идентификатор поля (одинаков во всех версиях раскладки)
+    std::size_t address; ///< Адрес первого байта поля
+    std::size_t size;    ///< Размер поля в байтах
+};
+
+/**
+ * @brief Перенос поля на новый адрес.
+ */
+struct FieldMove
+{
+    uint16_t id;      ///< Идентификатор поля
+    std::size_t from; ///< Адрес в старой раскладке
+    std::size_t to;   ///< Адрес в новой раскладке
+    std::size_t size; ///< Размер поля в байтах
+};
+
+#endif // EEPROM_LAYOUT_HPP
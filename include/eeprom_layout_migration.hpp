@@ -0,0 +1,206 @@
+#ifndef EEPROM_LAYOUT_MIGRATION_HPP
+#define EEPROM_LAYOUT_MIGRATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_layout.hpp"
+
+/**
+ * @file eeprom_layout_migration.hpp
+ * @brief Миграция данных EEPROM между версиями раскладки.
+ *
+ * Переписываются только страницы, содержимое которых меняется
+ * из-за переноса или добавления полей. Порядок записи и журнал
+ * обеспечивают продолжение миграции после пропадания питания.
+ */
+
+/**
+ * @brief Механизм миграции между двумя раскладками полей.
+ *
+ * Поля сопоставляются по id. Байты новой раскладки берутся
+ * из старого адреса поля, новые поля (и выросшие части полей)
+ * заполняются 0xFF, байты вне полей новой раскладки не меняются.
+ *
+ * Порядок записи страниц — топологический: страница переписывается
+ * только после всех страниц, которые читают её старое содержимое.
+ * Каждая страница сначала записывается в журнал (страница данных
+ * и заголовок с номером шага), и только затем — на своё место.
+ * Если питание пропало, повторный вызов run() с теми же раскладками
+ * довершает прерванный шаг из журнала и продолжает миграцию.
+ * Повторный run() уже завершённой миграции ничего не делает.
+ *
+ * Циклические зависимости (например, обмен полями между двумя
+ * страницами) разрываются через буферную страницу журнала: новое
+ * содержимое одной страницы цикла собирается, пока её источники
+ * целы, и сохраняется в буфер (шаг STAGE); на место она переносится
+ * из буфера (шаг COMMIT), когда её старое содержимое уже прочитано.
+ * В буфере одновременно находится одна страница.
+ *
+ * Каждый заголовок журнала содержит CRC-32 плана (пары раскладок),
+ * поэтому прерванный журнал другой миграции не продолжается.
+ *
+ * Стоимость: три цикла tWC на каждую изменённую страницу (четыре
+ * для страницы, проходящей через буфер) и один на завершение —
+ * пропорционально размеру изменения, а не микросхемы.
+ */
+class EEPROMLayoutMigration
+{
+public:
+    /**
+     * @brief Количество страниц в микросхеме.
+     */
+    static constexpr std::size_t PAGE_COUNT =
+        EEPROM25LC040A::CAPACITY_BYTES / EEPROM25LC040A::PAGE_SIZE;
+
+    static_assert(PAGE_COUNT <= 32, "маска страниц должна помещаться в uint32_t");
+
+    /**
+     * @brief Размер журнала: две страницы заголовков (по слоту на страницу),
+     *        страница данных шага и буфер разрыва циклов.
+     */
+    static constexpr std::size_t JOURNAL_SIZE = 4 * EEPROM25LC040A::PAGE_SIZE;
+
+    /**
+     * @brief Максимальное количество шагов: запись каждой страницы
+     *        и сохранение в буфер для каждой страницы цикла.
+     */
+    static constexpr std::size_t MAX_STEPS = 2 * PAGE_COUNT;
+
+    /**
+     * @brief Вид шага плана.
+     */
+    enum class StepKind : uint8_t
+    {
+        WRITE,  ///< Страница через страницу данных журнала на место
+        STAGE,  ///< Новое содержимое страницы в буфер журнала
+        COMMIT, ///< Страница из буфера журнала на место
+    };
+
+    /**
+     * @brief Конструктор.
+     *
+     * @param eeprom         Микросхема.
+     * @param oldLayout      Старая раскладка.
+     * @param oldCount       Количество полей старой раскладки.
+     * @param newLayout      Новая раскладка.
+     * @param newCount       Количество полей новой раскладки.
+     * @param journalAddress Адрес журнала (граница страницы, JOURNAL_SIZE байт,
+     *                       вне полей обеих раскладок).
+     */
+    EEPROMLayoutMigration(EEPROM25LC040A &eeprom,
+                          const FieldPlacement *oldLayout,
+                          std::size_t oldCount,
+                          const FieldPlacement *newLayout,
+                          std::size_t newCount,
+                          std::size_t journalAddress);
+
+    /**
+     * @brief Вычислить набор и порядок перезаписываемых страниц.
+     *
+     * План зависит только от раскладок, поэтому после пропадания
+     * питания он вычисляется так же.
+     *
+     * @return false, если раскладки некорректны или для разрыва
+     *         циклов нужно больше одной страницы буфера одновременно.
+     */
+    bool plan();
+
+    /**
+     * @brief Количество шагов в плане.
+     */
+    std::size_t stepCount() const { return stepCount_; }
+
+    /**
+     * @brief Номер страницы шага step.
+     */
+    std::size_t stepPage(std::size_t step) const { return order_[step]; }
+
+    /**
+     * @brief Вид шага step.
+     */
+    StepKind stepKind(std::size_t step) const { return kinds_[step]; }
+
+    /**
+     * @brief Выполнить (или продолжить прерванную) миграцию.
+     *
+     * @return false, если план не построен или журнал относится
+     *         к другой миграции.
+     */
+    bool run();
+
+private:
+    /**
+     * @brief Заголовок шага в журнале.
+     */
+    struct JournalSlot
+    {
+        uint8_t generation; ///< Номер записи заголовка (по модулю 256)
+        uint8_t step;       ///< Номер шага или STEP_DONE
+        uint8_t page;       ///< Страница шага
+        uint32_t planCrc;   ///< Признак плана (planTag())
+        uint32_t dataCrc;   ///< CRC-32 данных шага
+    };
+
+    /**
+     * @brief Найти самый свежий корректный заголовок журнала.
+     *
+     * @param header Содержимое страниц заголовков.
+     * @param slot   Найденный заголовок.
+     * @param index  Номер слота найденного заголовка.
+     * @return false, если корректных заголовков нет.
+     */
+    static bool readLatestSlot(const uint8_t *header, JournalSlot &slot, std::size_t &index);
+
+    /**
+     * @brief Записать заголовок в слот index.
+     */
+    void writeSlot(std::size_t index, const JournalSlot &slot);
+
+    /**
+     * @brief CRC-32 пары раскладок.
+     *
+     * Записывается в каждый заголовок: прерванная миграция продолжается
+     * только с тем же планом, а повторный run() завершённой ничего не делает.
+     */
+    uint32_t planTag() const;
+
+    /**
+     * @brief Найти поле старой раскладки по id.
+     */
+    const FieldPlacement *findOldField(uint16_t id) const;
+
+    /**
+     * @brief Готова ли страница к записи на место.
+     *
+     * Страница готова, если её старое содержимое не читает ни одна
+     * ожидающая страница, кроме сохранённой в буфер.
+     */
+    static bool isReady(std::size_t page, uint32_t pending, std::size_t staged,
+                        const uint32_t *sources);
+
+    /**
+     * @brief Добавить шаг в план.
+     */
+    void addStep(StepKind kind, std::size_t page);
+
+    /**
+     * @brief Собрать новое содержимое страницы из текущего образа.
+     */
+    void buildPage(std::size_t page, const uint8_t *image, uint8_t *out) const;
+
+private:
+    EEPROM25LC040A &eeprom_;
+    const FieldPlacement *oldLayout_;
+    std::size_t oldCount_;
+    const FieldPlacement *newLayout_;
+    std::size_t newCount_;
+    std::size_t journalAddress_;
+
+    bool planned_;
+    std::size_t stepCount_;
+    uint8_t order_[MAX_STEPS];  ///< Страницы шагов в порядке выполнения
+    StepKind kinds_[MAX_STEPS]; ///< Виды шагов
+};
+
+#endif // EEPROM_LAYOUT_MIGRATION_HPP
@@ -0,0 +1,117 @@
+#ifndef EEPROM_LAYOUT_OPTIMIZER_HPP
+#define EEPROM_LAYOUT_OPTIMIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "eeprom_layout.hpp"
+
+/**
+ * @file eeprom_layout_optimizer.hpp
+ * @brief Оптимизатор размещения полей по профилю записей.
+ *
+ * Инструмент для хоста: по трассе записей уровня API находит
+ * размещение, при котором поля, обновляемые вместе, попадают
+ * в одну страницу, и число программируемых страниц на пакет
+ * обновлений минимально.
+ */
+
+/**
+ * @brief Оптимизатор размещения полей.
+ *
+ * Порядок работы:
+ *  - конструктор получает текущую раскладку
+ *  - addWrite() / endBatch() принимают трассу записей
+ *  - optimize() вычисляет новую раскладку
+ *  - migrationPlan() возвращает список переносов полей
+ *
+ * Алгоритм жадный: пары полей объединяются в группы в порядке
+ * убывания числа совместных обновлений, пока группа помещается
+ * в страницу; затем группы упаковываются в страницы
+ * (first-fit decreasing). Поля крупнее страницы размещаются
+ * с границы страницы.
+ */
+class FieldLayoutOptimizer
+{
+public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param current     Текущая раскладка.
+     * @param count       Количество полей.
+     * @param regionStart Начальный адрес области для новой раскладки.
+     * @param regionSize  Размер области в байтах.
+     */
+    FieldLayoutOptimizer(const FieldPlacement *current,
+                         std::size_t count,
+                         std::size_t regionStart,
+                         std::size_t regionSize);
+
+    /**
+     * @brief Учесть запись из трассы.
+     *
+     * Запись относится ко всем полям текущей раскладки,
+     * с которыми пересекается.
+     *
+     * @param address Начальный адрес записи.
+     * @param length  Длина записи.
+     */
+    void addWrite(std::size_t address, std::size_t length);
+
+    /**
+     * @brief Завершить пакет обновлений (например, вызов sync()).
+     */
+    void endBatch();
+
+    /**
+     * @brief Вычислить новую раскладку.
+     *
+     * @return false, если раскладка или область некорректны
+     *         (см. validLayout()) или поля не помещаются в область;
+     *         layout() при этом не меняется.
+     */
+    bool optimize();
+
+    /**
+     * @brief Новая раскладка, в порядке полей текущей.
+     *
+     * Результат последнего успешного optimize(), до него - текущая раскладка.
+     */
+    const std::vector<FieldPlacement> &layout() const { return optimized_; }
+
+    /**
+     * @brief Переносы полей, адреса которых изменились.
+     */
+    std::vector<FieldMove> migrationPlan() const;
+
+    /**
+     * @brief Суммарное число программируемых страниц по всей трассе.
+     *
+     * @param layout Раскладка, для которой выполняется оценка.
+     */
+    std::size_t pagePrograms(const std::vector<FieldPlacement> &layout) const;
+
+    /**
+     * @brief Проверить раскладку.
+     *
+     * @return false, если есть поле нулевого размера
+     *         или поле выходит за пределы микросхемы.
+     */
+    static bool validLayout(const std::vector<FieldPlacement> &layout);
+
+    /**
+     * @brief Текущая раскладка.
+     */
+    const std::vector<FieldPlacement> &currentLayout() const { return current_; }
+
+private:
+    std::vector<FieldPlacement> current_;
+    std::vector<FieldPlacement> optimized_;
+    std::size_t regionStart_;
+    std::size_t regionSize_;
+
+    std::vector<std::vector<std::size_t>> batches_; ///< Индексы полей каждого пакета
+    std::vector<std::size_t> openBatch_;            ///< Поля текущего пакета
+};
+
+#endif // EEPROM_LAYOUT_OPTIMIZER_HPP
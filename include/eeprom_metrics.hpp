@@ -0,0 +1,131 @@
+#ifndef EEPROM_METRICS_HPP
+#define EEPROM_METRICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_operation_listener.hpp"
+#include "eeprom_shadow.hpp"
+
+/**
+ * @file eeprom_metrics.hpp
+ * @brief Метрики EEPROM в текстовом формате Prometheus.
+ *
+ * EEPROMMetrics собирает по операциям счётчики, гистограммы
+ * длительности (корзины по степеням двойки микросекунд) и износ
+ * страниц; formatPrometheus() выводит их вместе со счётчиками шины
+ * и зеркала в формате text exposition 0.0.4. Запись в файл для
+ * textfile-коллектора node_exporter - на хосте, см. eeprom_metrics_file.hpp;
+ * отдачи через сокет нет, коллектор читает файл.
+ *
+ * Кеша с промахами при чтении в библиотеке нет: EEPROMShadow - полное
+ * зеркало, его чтение всегда из RAM. Поэтому вместо попаданий и промахов
+ * кеша выводятся счётчики зеркала - страницы, подтверждённые и перечитанные
+ * проверкой согласованности, и записанные и пропущенные при сбросе.
+ * Попадания и промахи политик LRU считает только модель на трассах
+ * (eeprom_cache_model.hpp).
+ */
+
+/**
+ * @brief Сборщик метрик операций одной микросхемы.
+ */
+class EEPROMMetrics : public EEPROMOperationListener
+{
+public:
+    /**
+     * @brief Количество видов операций (EEPROMOperation).
+     */
+    static constexpr std::size_t OPERATION_COUNT = 8;
+
+    /**
+     * @brief Количество корзин гистограммы длительности.
+     *
+     * Корзина i (i < LATENCY_BUCKETS - 1) - длительность не больше 2^i мкс,
+     * последняя - все остальные.
+     */
+    static constexpr std::size_t LATENCY_BUCKETS = 24;
+
+    /**
+     * @brief Количество страниц микросхемы.
+     */
+    static constexpr std::size_t PAGE_COUNT = EEPROM25LC040A::CAPACITY_BYTES / EEPROM25LC040A::PAGE_SIZE;
+
+    /**
+     * @brief Показатели одного вида операций.
+     */
+    struct OperationStatistics
+    {
+        uint64_t count;                    ///< Количество операций
+        uint64_t bytes;                    ///< Затронуто байт
+        uint64_t latencySumUs;             ///< Суммарная длительность
+        uint32_t latency[LATENCY_BUCKETS]; ///< Гистограмма (не накопительная)
+    };
+
+    /**
+     * @brief Конструктор.
+     *
+     * @param eeprom Микросхема, к которой добавлен сборщик (см. EEPROMOperationMeter).
+     * @param clock  Источник времени (nullptr - длительность не измеряется).
+     */
+    EEPROMMetrics(const EEPROM25LC040A &eeprom, EEPROMClockFunction clock);
+
+    void onOperationBegin(const EEPROMOperationInfo &info) override;
+    void onOperationEnd(const EEPROMOperationInfo &info) override;
+
+    /**
+     * @brief Микросхема, к которой относятся метрики.
+     */
+    const EEPROM25LC040A &eeprom() const { return eeprom_; }
+
+    /**
+     * @brief Показатели вида операций.
+     */
+    const OperationStatistics &operation(EEPROMOperation op) const;
+
+    /**
+     * @brief Циклы записи, отнесённые к странице.
+     *
+     * Циклы операции распределяются по затронутым ею страницам по порядку;
+     * для writeArray и writeByte это точное значение, для битовых операций
+     * и writeFields, пересекающих границу страницы, - оценка.
+     */
+    uint64_t pageWrites(std::size_t page) const { return pageWrites_[page]; }
+
+    /**
+     * @brief Оценка квантиля длительности по гистограмме.
+     *
+     * @param op       Вид операций.
+     * @param quantile Квантиль в диапазоне [0, 1].
+     * @return Верхняя граница корзины, в которую попадает квантиль, мкс;
+     *         0, если операций не было.
+     */
+    uint64_t latencyQuantileUs(EEPROMOperation op, double quantile) const;
+
+private:
+    static std::size_t indexOf(EEPROMOperation op);
+
+private:
+    const EEPROM25LC040A &eeprom_;
+    EEPROMOperationMeter meter_;
+
+    OperationStatistics operations_[OPERATION_COUNT];
+    uint64_t pageWrites_[PAGE_COUNT];
+};
+
+/**
+ * @brief Вывести метрики в текстовом формате Prometheus.
+ *
+ * @param metrics  Метрики операций и шины.
+ * @param shadow   Счётчики зеркала (nullptr - не выводить).
+ * @param chip     Значение метки chip (идентификатор микросхемы).
+ * @param buffer   Буфер для текста (завершается нулём).
+ * @param capacity Размер буфера.
+ * @return Длина текста; 0, если текст не поместился в буфер.
+ */
+std::size_t formatPrometheus(const EEPROMMetrics &metrics,
+                             const EEPROMShadow::Statistics *shadow,
+                             const char *chip,
+                             char *buffer,
+                             std::size_t capacity);
+
+#endif // EEPROM_METRICS_HPP
@@ -0,0 +1,29 @@
+#ifndef EEPROM_METRICS_FILE_HPP
+#define EEPROM_METRICS_FILE_HPP
+
+#include <cstddef>
+
+/**
+ * @file eeprom_metrics_file.hpp
+ * @brief Запись метрик в файл для textfile-коллектора node_exporter.
+ *
+ * Только для хоста (библиотека eeprom_host): текст метрик
+ * готовит formatPrometheus() из eeprom_metrics.hpp.
+ */
+
+/**
+ * @brief Атомарно записать текст метрик в файл.
+ *
+ * Текст пишется во временный файл с уникальным именем рядом с целевым
+ * (mkstemp), который затем переименовывается: читатель видит либо старую,
+ * либо новую версию целиком, а одновременные писатели не затирают
+ * временные файлы друг друга.
+ *
+ * @param path   Путь к файлу (например, для textfile-коллектора).
+ * @param text   Текст.
+ * @param length Длина текста.
+ * @return false при ошибке записи.
+ */
+bool writeMetricsFile(const char *path, const char *text, std::size_t length);
+
+#endif // EEPROM_METRICS_FILE_HPP
@@ -0,0 +1,181 @@
+#ifndef EEPROM_OPERATION_LISTENER_HPP
+#define EEPROM_OPERATION_LISTENER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file eeprom_operation_listener.hpp
+ * @brief Интерфейс наблюдения за операциями EEPROM25LC040A.
+ *
+ * Позволяет записывать трассы, профилировать и собирать метрики,
+ * не меняя код, вызывающий драйвер.
+ */
+
+/**
+ * @brief Публичные операции EEPROM25LC040A.
+ */
+enum class EEPROMOperation : uint8_t
+{
+    READ_BYTE = 1,    ///< readByte
+    WRITE_BYTE = 2,   ///< writeByte
+    READ_ARRAY = 3,   ///< readArray
+    WRITE_ARRAY = 4,  ///< writeArray
+    READ_BITS = 5,    ///< readBit / readBits (length - количество бит)
+    WRITE_BITS = 6,   ///< writeBit / writeBits (length - количество бит)
+    READ_FIELDS = 7,  ///< readFields (покрывающий диапазон байт)
+    WRITE_FIELDS = 8  ///< writeFields (покрывающий диапазон байт)
+};
+
+/**
+ * @brief Имя операции для отчётов.
+ */
+inline const char *operationName(EEPROMOperation op)
+{
+    switch (op)
+    {
+    case EEPROMOperation::READ_BYTE:
+        return "READ_BYTE";
+    case EEPROMOperation::WRITE_BYTE:
+        return "WRITE_BYTE";
+    case EEPROMOperation::READ_ARRAY:
+        return "READ_ARRAY";
+    case EEPROMOperation::WRITE_ARRAY:
+        return "WRITE_ARRAY";
+    case EEPROMOperation::READ_BITS:
+        return "READ_BITS";
+    case EEPROMOperation::WRITE_BITS:
+        return "WRITE_BITS";
+    case EEPROMOperation::READ_FIELDS:
+        return "READ_FIELDS";
+    case EEPROMOperation::WRITE_FIELDS:
+        return "WRITE_FIELDS";
+    }
+    return "UNKNOWN";
+}
+
+/**
+ * @brief Описание операции, передаваемое наблюдателю.
+ */
+struct EEPROMOperationInfo
+{
+    EEPROMOperation op;  ///< Операция
+    std::size_t address; ///< Начальный адрес
+    std::size_t length;  ///< Длина в байтах (для битовых операций - в битах)
+    unsigned bitOffset;  ///< Смещение в битах (только для битовых операций)
+};
+
+/**
+ * @brief Источник времени в микросекундах.
+ */
+using EEPROMClockFunction = uint32_t (*)();
+
+/**
+ * @brief Счётчики обращений к шине одной микросхемы.
+ */
+struct EEPROMBusStatistics
+{
+    uint64_t frames;      ///< Кадры (опусканий CS)
+    uint64_t bytes;       ///< Переданные байты (тактов SCLK - в 8 раз больше)
+    uint64_t writeCycles; ///< Начатые циклы внутренней записи (tWC)
+    uint64_t statusPolls; ///< Чтения регистра статуса
+    uint64_t delayUs;     ///< Время ожидания WIP в delay_us()
+};
+
+/**
+ * @brief Наблюдатель за операциями EEPROM.
+ *
+ * Вызывается только для внешних вызовов: операции, которые драйвер
+ * выполняет внутри другой операции (например, readByte внутри
+ * writeBits), наблюдателю не сообщаются.
+ */
+class EEPROMOperationListener
+{
+public:
+    /**
+     * @brief Виртуальный деструктор.
+     */
+    virtual ~EEPROMOperationListener() = default;
+
+    /**
+     * @brief Операция началась.
+     *
+     * @param info Описание операции.
+     */
+    virtual void onOperationBegin(const EEPROMOperationInfo &info) = 0;
+
+    /**
+     * @brief Операция завершилась.
+     *
+     * @param info Описание операции.
+     */
+    virtual void onOperationEnd(const EEPROMOperationInfo &info) = 0;
+};
+
+/**
+ * @brief Замер стоимости одной операции для наблюдателей.
+ *
+ * start() вызывается из onOperationBegin(), а busDelta() и elapsedUs() -
+ * из onOperationEnd(): они возвращают, сколько кадров, байт, циклов tWC
+ * и времени потратила сама операция. Счётчики - busStatistics() той
+ * микросхемы, к которой наблюдатель добавлен через addListener().
+ */
+class EEPROMOperationMeter
+{
+public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param bus   Счётчики шины микросхемы (EEPROM25LC040A::busStatistics()).
+     * @param clock Источник времени (nullptr - время не измеряется).
+     */
+    EEPROMOperationMeter(const EEPROMBusStatistics &bus, EEPROMClockFunction clock)
+        : bus_(bus), clock_(clock), startBus_{}, startUs_(0) {}
+
+    /**
+     * @brief Запомнить счётчики и время начала операции.
+     */
+    void start()
+    {
+        startBus_ = bus_;
+        startUs_ = now();
+    }
+
+    /**
+     * @brief Счётчики шины с начала операции.
+     */
+    EEPROMBusStatistics busDelta() const
+    {
+        return EEPROMBusStatistics{bus_.frames - startBus_.frames,
+                                   bus_.bytes - startBus_.bytes,
+                                   bus_.writeCycles - startBus_.writeCycles,
+                                   bus_.statusPolls - startBus_.statusPolls,
+                                   bus_.delayUs - startBus_.delayUs};
+    }
+
+    /**
+     * @brief Задан ли источник времени.
+     */
+    bool hasClock() const { return clock_ != nullptr; }
+
+    /**
+     * @brief Время начала операции (0 без источника времени).
+     */
+    uint32_t startUs() const { return startUs_; }
+
+    /**
+     * @brief Время с начала операции (0 без источника времени).
+     */
+    uint32_t elapsedUs() const { return now() - startUs_; }
+
+private:
+    uint32_t now() const { return (clock_ != nullptr) ? clock_() : 0; }
+
+private:
+    const EEPROMBusStatistics &bus_;
+    EEPROMClockFunction clock_;
+    EEPROMBusStatistics startBus_;
+    uint32_t startUs_;
+};
+
+#endif // EEPROM_OPERATION_LISTENER_HPP
@@ -0,0 +1,171 @@
+#ifndef EEPROM_PAGE_HASH_TREE_HPP
+#define EEPROM_PAGE_HASH_TREE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+
+/**
+ * @file eeprom_page_hash_tree.hpp
+ * @brief Дерево хешей (Merkle tree) над страницами EEPROM.
+ *
+ * Позволяет:
+ *  - проверять целостность отдельных областей, читая только их страницы
+ *  - обновлять хеши после записи страницы за O(log n) узлов
+ *  - проверять согласованность дерева при старте без перечитывания данных
+ */
+
+/**
+ * @brief Дерево хешей над группой страниц EEPROM.
+ *
+ * Защищаются pageCount страниц, начиная с firstPage. Все узлы дерева
+ * (2 * pageCount - 1 значений CRC-32) хранятся на микросхеме
+ * в зарезервированной области treeAddress и дублируются в RAM.
+ *
+ * Лист — CRC-32 страницы с номером страницы в качестве начального
+ * значения, узел — CRC-32 от пары хешей потомков. CRC-32 обнаруживает
+ * случайные повреждения; для защиты от умышленной подмены корень
+ * нужно сравнивать с доверенной копией, хранящейся вне микросхемы.
+ */
+class EEPROMPageHashTree
+{
+public:
+    /**
+     * @brief Максимальное количество защищаемых страниц.
+     */
+    static constexpr std::size_t MAX_PAGES =
+        EEPROM25LC040A::CAPACITY_BYTES / EEPROM25LC040A::PAGE_SIZE;
+
+    /**
+     * @brief Размер одного узла на микросхеме в байтах.
+     */
+    static constexpr std::size_t NODE_SIZE = sizeof(uint32_t);
+
+    /**
+     * @brief Конструктор.
+     *
+     * Количество страниц должно быть степенью двойки, защищаемые страницы
+     * и область дерева должны помещаться на микросхеме и не пересекаться.
+     * Иначе дерево некорректно (valid() == false) и ничего не защищает:
+     * build() и update() ничего не делают, load() и verify() возвращают false.
+     *
+     * @param eeprom      Микросхема.
+     * @param firstPage   Номер первой защищаемой страницы.
+     * @param pageCount   Количество страниц (степень двойки, не более MAX_PAGES).
+     * @param treeAddress Адрес области хранения дерева (treeSize() байт),
+     *                    не пересекающейся с защищаемыми страницами.
+     */
+    EEPROMPageHashTree(EEPROM25LC040A &eeprom,
+                       std::size_t firstPage,
+                       std::size_t pageCount,
+                       std::size_t treeAddress);
+
+    /**
+     * @brief Корректны ли параметры дерева.
+     */
+    bool valid() const { return pageCount_ != 0; }
+
+    /**
+     * @brief Количество защищаемых страниц (0 для некорректного дерева).
+     */
+    std::size_t pageCount() const { return pageCount_; }
+
+    /**
+     * @brief Размер области хранения дерева в байтах.
+     */
+    std::size_t treeSize() const { return valid() ? nodeCount() * NODE_SIZE : 0; }
+
+    /**
+     * @brief Построить дерево по всем страницам и записать его.
+     *
+     * Выполняется один раз при подготовке микросхемы.
+     */
+    void build();
+
+    /**
+     * @brief Загрузить дерево с микросхемы.
+     *
+     * Дерево читается одним кадром; каждый внутренний узел
+     * сверяется с хешем своих потомков без чтения данных.
+     *
+     * @return true  — дерево согласовано.
+     * @return false — дерево повреждено.
+     */
+    bool load();
+
+    /**
+     * @brief Корень дерева.
+     */
+    uint32_t root() const { return nodes_[0]; }
+
+    /**
+     * @brief Обновить хеши после изменения области.
+     *
+     * Перечитываются только страницы области, пересчитываются
+     * их пути до корня, и на микросхему записываются только
+     * изменившиеся узлы.
+     *
+     * @param address Начальный адрес изменённой области.
+     * @param length  Длина области.
+     */
+    void update(std::size_t address, std::size_t length);
+
+    /**
+     * @brief Записать данные и обновить дерево.
+     *
+     * @param address Начальный адрес.
+     * @param buffer  Данные.
+     * @param length  Количество байт.
+     */
+    void write(std::size_t address, const uint8_t *buffer, std::size_t length);
+
+    /**
+     * @brief Проверить целостность области.
+     *
+     * Читаются только страницы, перекрывающиеся с областью,
+     * и их хеши сравниваются с листьями дерева.
+     *
+     * @param address Начальный адрес.
+     * @param length  Длина области.
+     * @return true, если все страницы области совпадают с деревом.
+     */
+    bool verify(std::size_t address, std::size_t length) const;
+
+private:
+    std::size_t nodeCount() const { return 2 * pageCount_ - 1; }
+
+    /**
+     * @brief Найти диапазон защищаемых страниц, перекрывающихся с областью.
+     *
+     * @return false, если пересечения нет.
+     */
+    bool pageRange(std::size_t address,
+                   std::size_t length,
+                   std::size_t &first,
+                   std::size_t &last) const;
+
+    /**
+     * @brief Хеш листа для страницы.
+     */
+    static uint32_t hashPage(std::size_t page, const uint8_t *data);
+
+    /**
+     * @brief Хеш внутреннего узла.
+     */
+    static uint32_t hashNode(uint32_t left, uint32_t right);
+
+    /**
+     * @brief Записать на микросхему узлы, отмеченные в маске.
+     */
+    void storeNodes(uint64_t mask);
+
+private:
+    EEPROM25LC040A &eeprom_;
+    std::size_t firstPage_;
+    std::size_t pageCount_;
+    std::size_t treeAddress_;
+
+    uint32_t nodes_[2 * MAX_PAGES - 1]; ///< Узлы: 0 - корень, потомки i - 2i+1 и 2i+2
+};
+
+#endif // EEPROM_PAGE_HASH_TREE_HPP
@@ -0,0 +1,78 @@
+#ifndef EEPROM_PATCH_HPP
+#define EEPROM_PATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+
+/**
+ * @file eeprom_patch.hpp
+ * @brief Двоичные патчи образа EEPROM.
+ *
+ * Формат патча (little-endian):
+ *  - заголовок: 4 байта "EPT1", CRC-32 исходного образа,
+ *    CRC-32 результата, количество участков (2 байта)
+ *  - участок: смещение (2 байта), длина (2 байта), затем данные
+ *
+ * Участки идут по возрастанию адреса и не перекрываются.
+ * CRC считаются по всей микросхеме (CAPACITY_BYTES байт), поэтому
+ * патч применяется только к тому образу, для которого он построен.
+ */
+
+/**
+ * @brief Размер заголовка патча.
+ */
+constexpr std::size_t PATCH_HEADER_SIZE = 14;
+
+/**
+ * @brief Размер заголовка участка патча.
+ */
+constexpr std::size_t PATCH_RUN_HEADER_SIZE = 4;
+
+/**
+ * @brief Результат применения патча.
+ */
+enum class EEPROMPatchResult : uint8_t
+{
+    APPLIED,         ///< Патч записан, результат проверен
+    ALREADY_APPLIED, ///< Микросхема уже содержит результат, запись не нужна
+    BAD_FORMAT,      ///< Патч повреждён или выходит за пределы микросхемы
+    BASE_MISMATCH,   ///< Содержимое микросхемы не совпадает с исходным образом
+    VERIFY_FAILED    ///< После записи CRC результата не совпал
+};
+
+/**
+ * @brief Построить патч из исходного образа в новый.
+ *
+ * Соседние изменённые участки, разделённые не более чем
+ * PATCH_RUN_HEADER_SIZE неизменёнными байтами, объединяются:
+ * так патч получается не длиннее.
+ *
+ * @param base     Исходный образ (CAPACITY_BYTES байт).
+ * @param target   Новый образ (CAPACITY_BYTES байт).
+ * @param patch    Буфер для патча.
+ * @param capacity Размер буфера.
+ * @return Размер патча; 0, если он не помещается в буфер.
+ */
+std::size_t makePatch(const uint8_t *base,
+                      const uint8_t *target,
+                      uint8_t *patch,
+                      std::size_t capacity);
+
+/**
+ * @brief Применить патч к микросхеме.
+ *
+ * Патч сначала проверяется целиком, затем CRC исходного образа
+ * считается по содержимому микросхемы кадрами чтения без буфера на
+ * весь образ. Изменённые байты группируются по страницам: каждая
+ * затронутая страница программируется один раз участком от первого
+ * до последнего изменённого байта. В конце проверяется CRC результата.
+ *
+ * @param eeprom Микросхема.
+ * @param patch  Патч.
+ * @param size   Размер патча.
+ * @return Результат применения.
+ */
+EEPROMPatchResult applyPatch(EEPROM25LC040A &eeprom, const uint8_t *patch, std::size_t size);
+
+#endif // EEPROM_PATCH_HPP
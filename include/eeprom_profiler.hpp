@@ -0,0 +1,211 @@
+#ifndef EEPROM_PROFILER_HPP
+#define EEPROM_PROFILER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_config.hpp"
+#include "eeprom_operation_listener.hpp"
+
+/**
+ * @file eeprom_profiler.hpp
+ * @brief Профилирование обращений к EEPROM по местам вызова.
+ *
+ * Код приложения отмечает свои участки областями (Scope) с тегом или
+ * адресом возврата; вложенные области образуют стек. Каждая операция
+ * EEPROM25LC040A относится к текущему стеку, и для пары (стек, операция)
+ * накапливаются такты SCLK, кадры, циклы tWC, время ожидания WIP
+ * и полное время. Результат выводится в формате folded stacks
+ * ("a;b;WRITE_ARRAY 1234"), который принимают flamegraph.pl и speedscope.
+ *
+ * Память не выделяется: места вызова хранятся в таблице из MAX_SITES
+ * элементов, при её заполнении новые места не учитываются.
+ */
+
+/**
+ * @brief Профилировщик обращений к шине по местам вызова.
+ */
+class EEPROMCallSiteProfiler : public EEPROMOperationListener
+{
+public:
+    /**
+     * @brief Максимальное количество мест вызова.
+     */
+    static constexpr std::size_t MAX_SITES = EEPROM_PROFILER_MAX_SITES;
+
+    /**
+     * @brief Максимальная глубина стека областей.
+     *
+     * Более глубокие области учитываются как самая глубокая сохранённая.
+     */
+    static constexpr std::size_t MAX_DEPTH = 8;
+
+    /**
+     * @brief Показатель для вывода.
+     */
+    enum class Metric : uint8_t
+    {
+        CALLS,        ///< Количество операций
+        CLOCKS,       ///< Такты SCLK
+        FRAMES,       ///< Кадры SPI
+        WRITE_CYCLES, ///< Циклы внутренней записи
+        WAIT_US,      ///< Ожидание WIP в delay_us()
+        WALL_US       ///< Полное время операций
+    };
+
+    /**
+     * @brief Накопленные показатели места вызова.
+     */
+    struct SiteStatistics
+    {
+        uint64_t calls;
+        uint64_t clocks;
+        uint64_t frames;
+        uint64_t writeCycles;
+        uint64_t statusPolls;
+        uint64_t waitUs;
+        uint64_t wallUs;
+    };
+
+    /**
+     * @brief Область кода приложения (RAII).
+     *
+     * Тег должен жить дольше профилировщика (обычно строковый литерал);
+     * теги сравниваются по указателю.
+     */
+    class Scope
+    {
+    public:
+        /**
+         * @brief Область с текстовым тегом.
+         */
+        Scope(EEPROMCallSiteProfiler &profiler, const char *tag)
+            : profiler_(profiler)
+        {
+            profiler_.push(tag, true);
+        }
+
+        /**
+         * @brief Область, помеченная адресом (например, адресом возврата).
+         */
+        Scope(EEPROMCallSiteProfiler &profiler, const void *address)
+            : profiler_(profiler)
+        {
+            profiler_.push(address, false);
+        }
+
+        ~Scope() { profiler_.pop(); }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        EEPROMCallSiteProfiler &profiler_;
+    };
+
+    /**
+     * @brief Конструктор.
+     *
+     * @param eeprom Микросхема, к которой добавлен профилировщик (см. EEPROMOperationMeter).
+     * @param clock  Источник времени (nullptr - время не измеряется).
+     */
+    EEPROMCallSiteProfiler(const EEPROM25LC040A &eeprom, EEPROMClockFunction clock);
+
+    void onOperationBegin(const EEPROMOperationInfo &info) override;
+    void onOperationEnd(const EEPROMOperationInfo &info) override;
+
+    /**
+     * @brief Сбросить накопленные данные (стек областей сохраняется).
+     */
+    void clear();
+
+    /**
+     * @brief Количество учтённых мест вызова.
+     */
+    std::size_t siteCount() const { return siteCount_; }
+
+    /**
+     * @brief Показатели места вызова по номеру.
+     */
+    const SiteStatistics &siteStatistics(std::size_t index) const { return sites_[index].stats; }
+
+    /**
+     * @brief Были ли операции, не учтённые из-за заполнения таблицы.
+     */
+    bool overflowed() const { return overflowed_; }
+
+    /**
+     * @brief Вывести данные в формате folded stacks.
+     *
+     * Строки: кадры стека через ';', затем имя операции, пробел и
+     * значение показателя. Адреса выводятся как 0x..., их можно
+     * перевести в имена через addr2line. Строки с нулевым значением
+     * пропускаются; не поместившиеся строки отбрасываются целиком.
+     *
+     * @param buffer   Буфер для текста (завершается нулём).
+     * @param capacity Размер буфера.
+     * @param metric   Показатель.
+     * @return Длина текста без завершающего нуля.
+     */
+    std::size_t dumpFolded(char *buffer, std::size_t capacity, Metric metric) const;
+
+private:
+    /**
+     * @brief Кадр стека областей: тег или адрес.
+     */
+    struct Frame
+    {
+        const void *pointer;
+        bool isTag;
+    };
+
+    /**
+     * @brief Место вызова: стек и операция.
+     */
+    struct Site
+    {
+        Frame frames[MAX_DEPTH];
+        std::size_t depth;
+        EEPROMOperation op;
+        SiteStatistics stats;
+    };
+
+    void push(const void *pointer, bool isTag);
+    void pop();
+
+    /**
+     * @brief Найти или добавить место вызова для текущего стека.
+     *
+     * @return nullptr, если таблица заполнена.
+     */
+    Site *findSite(EEPROMOperation op);
+
+    static uint64_t metricValue(const SiteStatistics &stats, Metric metric);
+
+private:
+    EEPROMOperationMeter meter_;
+
+    Frame stack_[MAX_DEPTH];
+    std::size_t depth_; ///< Глубина стека, может быть больше MAX_DEPTH
+
+    Site sites_[MAX_SITES];
+    std::size_t siteCount_;
+    bool overflowed_;
+};
+
+/**
+ * @brief Отметить текущую функцию тегом с её именем.
+ */
+#define EEPROM_PROFILE_FUNCTION(profiler) \
+    EEPROMCallSiteProfiler::Scope eeprom_profile_scope_((profiler), __func__)
+
+#if defined(__GNUC__)
+/**
+ * @brief Отметить текущую функцию адресом возврата (место, откуда её вызвали).
+ */
+#define EEPROM_PROFILE_CALLER(profiler) \
+    EEPROMCallSiteProfiler::Scope eeprom_profile_scope_((profiler), \
+                                                        static_cast<const void *>(__builtin_return_address(0)))
+#endif
+
+#endif // EEPROM_PROFILER_HPP
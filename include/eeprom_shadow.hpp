@@ -0,0 +1,345 @@
+#ifndef EEPROM_SHADOW_HPP
+#define EEPROM_SHADOW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_config.hpp"
+
+/**
+ * @file eeprom_shadow.hpp
+ * @brief Теневая копия EEPROM в оперативной памяти.
+ *
+ * Содержимое микросхемы отображается в обычный массив в RAM:
+ *  - чтение — обычные обращения к памяти
+ *  - запись — изменение массива напрямую (в том числе через структуры)
+ *  - sync() — запись на микросхему только изменённых страниц
+ */
+
+/**
+ * @brief Теневая копия (зеркало) EEPROM 25LC040A.
+ *
+ * Вместо отслеживания записей через mprotect/SIGSEGV (недоступно
+ * на микроконтроллерах) хранится вторая копия последнего записанного
+ * на микросхему образа. При sync() страницы сравниваются с ней,
+ * и программируются только отличающиеся — по одному циклу tWC на страницу,
+ * независимо от того, сколько раз менялись её байты.
+ */
+class EEPROMShadow
+{
+public:
+    /**
+     * @brief Количество страниц в микросхеме.
+     */
+    static constexpr std::size_t PAGE_COUNT =
+        EEPROM25LC040A::CAPACITY_BYTES / EEPROM25LC040A::PAGE_SIZE;
+
+    static_assert(PAGE_COUNT <= 32, "маска страниц должна помещаться в uint32_t");
+
+    /**
+     * @brief Максимальное количество одновременных подписок.
+     */
+    static constexpr std::size_t MAX_SUBSCRIPTIONS = EEPROM_SHADOW_MAX_SUBSCRIPTIONS;
+
+    /**
+     * @brief Обработчик изменения области.
+     *
+     * @param address Адрес первого изменённого байта области.
+     * @param length  Длина участка от первого до последнего изменённого байта.
+     * @param context Пользовательский контекст, переданный в subscribe().
+     */
+    using ChangeCallback = void (*)(std::size_t address, std::size_t length, void *context);
+
+    /**
+     * @brief Максимальное количество групп записи, закрытых барьерами.
+     */
+    static constexpr std::size_t MAX_BARRIERS = EEPROM_SHADOW_MAX_BARRIERS;
+
+    /**
+     * @brief Уровень сохранности записи.
+     */
+    enum class Durability : uint8_t
+    {
+        VOLATILE, ///< Только RAM, на микросхему - при sync()
+        BUFFERED, ///< На микросхему не позже чем через flushDelay (см. poll())
+        DURABLE   ///< Страницы записаны и WIP сброшен к моменту возврата
+    };
+
+    /**
+     * @brief Счётчики работы зеркала.
+     */
+    struct Statistics
+    {
+        uint64_t coherencyHits;   ///< Страницы, подтверждённые checkCoherency()
+        uint64_t coherencyMisses; ///< Страницы, перечитанные checkCoherency()
+        uint64_t pagesProgrammed; ///< Страницы, записанные на микросхему
+        uint64_t pagesSkipped;    ///< Страницы сброса, не требовавшие записи
+    };
+
+    /**
+     * @brief Конструктор.
+     *
+     * @param eeprom Микросхема, содержимое которой отображается.
+     */
+    explicit EEPROMShadow(EEPROM25LC040A &eeprom);
+
+    /**
+     * @brief Загрузить содержимое микросхемы одним чтением.
+     */
+    void load();
+
+    /**
+     * @brief Указатель на образ памяти для чтения.
+     */
+    const uint8_t *data() const { return image_; }
+
+    /**
+     * @brief Указатель на образ памяти для записи.
+     *
+     * Изменения попадают на микросхему только после sync().
+     */
+    uint8_t *data() { return image_; }
+
+    /**
+     * @brief Размер образа в байтах.
+     */
+    static constexpr std::size_t size() { return EEPROM25LC040A::CAPACITY_BYTES; }
+
+    /**
+     * @brief Маска страниц, отличающихся от записанного на микросхему образа.
+     *
+     * @return Бит N установлен, если страница N изменена.
+     */
+    uint32_t dirtyPages() const;
+
+    /**
+     * @brief Записать на микросхему все изменённые страницы.
+     *
+     * @return Количество запрограммированных страниц.
+     */
+    std::size_t sync();
+
+    /**
+     * @brief Записать данные с заданным уровнем сохранности.
+     *
+     * Позволяет на одной микросхеме не ждать tWC для телеметрии
+     * (VOLATILE, BUFFERED) и синхронно сохранять важные настройки
+     * (DURABLE). При DURABLE записываются только затронутые страницы,
+     * но целиком — вместе с другими несохранёнными изменениями в них.
+     * Пока источник времени не задан (setFlushDelay()), BUFFERED
+     * выполняется как DURABLE.
+     *
+     * @param address    Начальный адрес.
+     * @param buffer     Данные.
+     * @param length     Количество байт.
+     * @param durability Уровень сохранности.
+     */
+    void write(std::size_t address,
+               const uint8_t *buffer,
+               std::size_t length,
+               Durability durability);
+
+    /**
+     * @brief Задать источник времени и предельную задержку для BUFFERED.
+     *
+     * Уже ожидающие BUFFERED-страницы получают новый срок, а при
+     * clock == nullptr записываются сразу.
+     *
+     * @param clock   Источник времени в микросекундах
+     *                (nullptr — BUFFERED-записи выполняются как DURABLE).
+     * @param delayUs Максимальная задержка записи BUFFERED-данных.
+     */
+    void setFlushDelay(EEPROMClockFunction clock, uint32_t delayUs);
+
+    /**
+     * @brief Записать BUFFERED-страницы, если их срок истёк.
+     *
+     * Вызывается периодически (например, из главного цикла);
+     * срок отсчитывается от первой BUFFERED-записи после сброса.
+     *
+     * @return Количество запрограммированных страниц.
+     */
+    std::size_t poll();
+
+    /**
+     * @brief Барьер упорядочивания записи.
+     *
+     * Все изменения, сделанные до барьера, будут записаны
+     * (с завершённым tWC) раньше, чем начнётся запись любых
+     * изменений после него. Между барьерами страницы
+     * по-прежнему объединяются и записываются в любом порядке.
+     *
+     * Если write() затрагивает страницу, ожидающую записи в группе
+     * до барьера, эта группа (и все более ранние) записывается сразу.
+     * Запись изменений после последнего барьера (DURABLE, poll())
+     * сначала записывает все закрытые группы.
+     * Для изменений напрямую через data() порядок гарантируется,
+     * только если страница после барьера не меняется до её записи.
+     *
+     * При заполнении MAX_BARRIERS групп все закрытые группы
+     * записываются немедленно.
+     */
+    void barrier();
+
+    /**
+     * @brief Подписаться на изменения области.
+     *
+     * Обработчик вызывается после sync(), если записанные на микросхему
+     * байты области изменились, — не более одного раза за sync().
+     * Если изменений нет, подписки ничего не стоят.
+     *
+     * @param address  Начальный адрес области.
+     * @param length   Длина области.
+     * @param callback Обработчик.
+     * @param context  Контекст, передаваемый обработчику.
+     * @return Идентификатор подписки или -1, если свободных слотов нет.
+     */
+    int subscribe(std::size_t address,
+                  std::size_t length,
+                  ChangeCallback callback,
+                  void *context = nullptr);
+
+    /**
+     * @brief Отменить подписку.
+     *
+     * @param id Идентификатор, полученный от subscribe().
+     */
+    void unsubscribe(int id);
+
+    /**
+     * @brief Включить таблицу контрольных сумм страниц на микросхеме.
+     *
+     * Таблица из PAGE_COUNT байт CRC-8 (по байту на страницу) хранится
+     * по адресу tableAddress и обновляется при каждом sync().
+     * Страницы, занятые самой таблицей, в ней не учитываются.
+     * Если таблица на микросхеме не совпадает с данными,
+     * она исправляется при следующем sync().
+     *
+     * @param tableAddress Адрес таблицы.
+     */
+    void enableCoherencyTable(std::size_t tableAddress);
+
+    /**
+     * @brief Проверить, не изменил ли микросхему внешний программатор.
+     *
+     * Таблица контрольных сумм читается одним коротким кадром
+     * и сравнивается с суммами зеркала. Перечитываются только
+     * страницы с отличающейся суммой; несохранённые изменения
+     * в этих страницах теряются. Подписчики уведомляются
+     * об изменённых байтах так же, как после sync().
+     *
+     * @return Маска перечитанных страниц.
+     */
+    uint32_t checkCoherency();
+
+    /**
+     * @brief Накопленные счётчики.
+     */
+    const Statistics &statistics() const { return stats_; }
+
+private:
+    /**
+     * @brief Подписка на изменения области.
+     */
+    struct Subscription
+    {
+        std::size_t address;
+        std::size_t length;
+        ChangeCallback callback; ///< nullptr - слот свободен
+        void *context;
+
+        // Изменённый участок в текущем sync()
+        std::size_t changedFirst;
+        std::size_t changedLast;
+        bool changed;
+    };
+
+    /**
+     * @brief Отметить изменённый байт в подписках, которые его покрывают.
+     */
+    void noteChange(std::size_t address);
+
+    /**
+     * @brief Вызвать обработчики подписок, области которых изменились.
+     */
+    void dispatchChanges();
+
+    /**
+     * @brief Пересчитать суммы страниц по записанному образу
+     * и занести их в таблицу рабочего образа.
+     */
+    void refreshPageChecksums();
+
+    /**
+     * @brief Обновить сумму страницы в таблице рабочего образа.
+     */
+    void updatePageChecksum(std::size_t page);
+
+    /**
+     * @brief Записать изменённые страницы, входящие в маску.
+     *
+     * @return Количество запрограммированных страниц.
+     */
+    std::size_t commitPages(uint32_t mask);
+
+    /**
+     * @brief Записать изменённые страницы маски, обновить таблицу сумм
+     * и уведомить подписчиков.
+     *
+     * @return Количество запрограммированных страниц.
+     */
+    std::size_t flush(uint32_t mask);
+
+    /**
+     * @brief Записать изменённые страницы маски: данные, затем таблицу сумм.
+     */
+    std::size_t commitOrdered(uint32_t mask);
+
+    /**
+     * @brief Страницы, входящие в группы, закрытые барьерами.
+     */
+    uint32_t groupedPages() const;
+
+    /**
+     * @brief Текущее время по источнику времени (0, если не задан).
+     */
+    uint32_t now() const;
+
+    /**
+     * @brief Проверить, отличается ли страница от записанного образа.
+     */
+    bool isPageDirty(std::size_t page) const;
+
+    /**
+     * @brief Записать одну изменённую страницу.
+     *
+     * Передаётся только участок от первого до последнего изменённого байта,
+     * что сокращает число тактов при том же одном цикле записи.
+     */
+    void commitPage(std::size_t page);
+
+private:
+    EEPROM25LC040A &eeprom_;
+
+    uint8_t image_[EEPROM25LC040A::CAPACITY_BYTES];     ///< Рабочий образ (RAM)
+    uint8_t committed_[EEPROM25LC040A::CAPACITY_BYTES]; ///< Образ, записанный на микросхему
+
+    Subscription subscriptions_[MAX_SUBSCRIPTIONS];
+
+    bool tableEnabled_;                 ///< Таблица контрольных сумм включена
+    std::size_t tableAddress_;          ///< Адрес таблицы на микросхеме
+    uint32_t tablePages_;               ///< Маска страниц, занятых таблицей
+    uint8_t pageChecksums_[PAGE_COUNT]; ///< Суммы страниц в записанном образе
+
+    EEPROMClockFunction clock_; ///< Источник времени для BUFFERED
+    uint32_t flushDelayUs_;     ///< Предельная задержка BUFFERED
+    uint32_t bufferedPages_;    ///< Страницы, ожидающие отложенного сброса
+    uint32_t bufferedDeadline_; ///< Срок сброса bufferedPages_
+
+    uint32_t groups_[MAX_BARRIERS]; ///< Группы страниц между барьерами (по порядку)
+    std::size_t groupCount_;        ///< Количество закрытых групп
+
+    Statistics stats_;
+};
+
+#endif // EEPROM_SHADOW_HPP
@@ -0,0 +1,146 @@
+#ifndef EEPROM_SLOW_LOG_HPP
+#define EEPROM_SLOW_LOG_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_operation_listener.hpp"
+
+/**
+ * @file eeprom_slow_log.hpp
+ * @brief Журнал медленных операций EEPROM.
+ *
+ * Наблюдатель измеряет каждую внешнюю операцию и, если она длилась
+ * дольше порога, кладёт запись с разбивкой (кадры, байты, опросы
+ * статуса, циклы tWC, время в delay_us) в кольцевой буфер без
+ * блокировок. Так в работающей системе ловятся редкие длинные циклы
+ * записи и ожидания шины без полной трассировки.
+ */
+
+/**
+ * @brief Запись о медленной операции.
+ */
+struct EEPROMSlowOperation
+{
+    EEPROMOperationInfo info; ///< Операция
+    uint32_t startUs;         ///< Время начала
+    uint32_t durationUs;      ///< Длительность
+    uint32_t frames;          ///< Кадры SPI
+    uint32_t bytes;           ///< Переданные байты
+    uint32_t statusPolls;     ///< Чтения регистра статуса
+    uint32_t writeCycles;     ///< Циклы внутренней записи
+    uint32_t delayUs;         ///< Время в delay_us() при ожидании WIP
+};
+
+/**
+ * @brief Журнал медленных операций (SPSC, без блокировок).
+ *
+ * Производитель - поток, выполняющий операции EEPROM (записи
+ * добавляются из onOperationEnd()); потребитель - поток, который
+ * забирает записи через tryPop(). При заполненном буфере новые
+ * записи отбрасываются и учитываются в dropped().
+ *
+ * @tparam Capacity Количество записей (степень двойки).
+ */
+template <std::size_t Capacity>
+class EEPROMSlowOperationLog : public EEPROMOperationListener
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "ёмкость журнала должна быть степенью двойки");
+
+public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param eeprom      Микросхема, к которой добавлен журнал (см. EEPROMOperationMeter).
+     * @param clock       Источник времени.
+     * @param thresholdUs Порог длительности операции.
+     */
+    EEPROMSlowOperationLog(const EEPROM25LC040A &eeprom, EEPROMClockFunction clock, uint32_t thresholdUs)
+        : meter_(eeprom.busStatistics(), clock), threshold_(thresholdUs)
+    {
+    }
+
+    /**
+     * @brief Изменить порог (можно из любого потока).
+     */
+    void setThreshold(uint32_t thresholdUs) { threshold_.store(thresholdUs, std::memory_order_relaxed); }
+
+    /**
+     * @brief Текущий порог.
+     */
+    uint32_t threshold() const { return threshold_.load(std::memory_order_relaxed); }
+
+    void onOperationBegin(const EEPROMOperationInfo &) override { meter_.start(); }
+
+    void onOperationEnd(const EEPROMOperationInfo &info) override
+    {
+        if (!meter_.hasClock())
+        {
+            return;
+        }
+
+        const uint32_t duration = meter_.elapsedUs();
+        if (duration <= threshold_.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const EEPROMBusStatistics bus = meter_.busDelta();
+        EEPROMSlowOperation &entry = entries_[tail & (Capacity - 1)];
+        entry.info = info;
+        entry.startUs = meter_.startUs();
+        entry.durationUs = duration;
+        entry.frames = static_cast<uint32_t>(bus.frames);
+        entry.bytes = static_cast<uint32_t>(bus.bytes);
+        entry.statusPolls = static_cast<uint32_t>(bus.statusPolls);
+        entry.writeCycles = static_cast<uint32_t>(bus.writeCycles);
+        entry.delayUs = static_cast<uint32_t>(bus.delayUs);
+
+        tail_.store(tail + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Забрать самую старую запись (только потребитель).
+     *
+     * @return false, если журнал пуст.
+     */
+    bool tryPop(EEPROMSlowOperation &entry)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        entry = entries_[head & (Capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Сколько записей отброшено из-за заполненного буфера.
+     */
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    EEPROMOperationMeter meter_; ///< Только производитель
+    std::atomic<uint32_t> threshold_;
+    std::atomic<uint32_t> dropped_{0};
+
+    EEPROMSlowOperation entries_[Capacity];
+
+    // Индексы на разных кеш-линиях, чтобы потоки не мешали друг другу
+    alignas(64) std::atomic<std::size_t> head_{0}; ///< Пишет только потребитель
+    alignas(64) std::atomic<std::size_t> tail_{0}; ///< Пишет только производитель
+};
+
+#endif // EEPROM_SLOW_LOG_HPP
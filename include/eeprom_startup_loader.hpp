@@ -0,0 +1,85 @@
+#ifndef EEPROM_STARTUP_LOADER_HPP
+#define EEPROM_STARTUP_LOADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "eeprom_shadow.hpp"
+
+/**
+ * @file eeprom_startup_loader.hpp
+ * @brief Параллельная загрузка зеркал EEPROM при старте.
+ *
+ * Микросхемы на одной шине загружаются последовательно (шина общая),
+ * а разные шины - одновременно, по потоку на шину. Время старта
+ * определяется самой медленной шиной, а не суммой всех микросхем.
+ */
+
+/**
+ * @brief Загрузчик зеркал EEPROMShadow для нескольких шин.
+ *
+ * Предполагается, что драйверы разных шин независимы и могут
+ * использоваться из разных потоков одновременно.
+ */
+class EEPROMStartupLoader
+{
+public:
+    /**
+     * @brief Время загрузки одной микросхемы.
+     */
+    struct ChipResult
+    {
+        std::size_t bus;     ///< Номер шины
+        std::size_t chip;    ///< Номер микросхемы на шине
+        uint64_t startUs;    ///< Начало загрузки от запуска run(), мкс
+        uint64_t loadTimeUs; ///< Длительность загрузки, мкс
+    };
+
+    /**
+     * @brief Конструктор.
+     */
+    EEPROMStartupLoader();
+
+    /**
+     * @brief Добавить шину.
+     *
+     * @return Номер шины для addChip().
+     */
+    std::size_t addBus();
+
+    /**
+     * @brief Добавить микросхему на шину.
+     *
+     * @param bus    Номер шины из addBus().
+     * @param shadow Зеркало микросхемы, которое нужно загрузить.
+     * @return false, если такой шины нет.
+     */
+    bool addChip(std::size_t bus, EEPROMShadow &shadow);
+
+    /**
+     * @brief Загрузить все зеркала.
+     *
+     * Блокирует вызывающий поток до окончания загрузки всех шин.
+     * Последняя шина загружается в вызывающем потоке, для остальных
+     * создаётся по потоку. Если поток создать не удалось, уже запущенные
+     * потоки дожидаются завершения, и исключение передаётся вызывающему.
+     */
+    void run();
+
+    /**
+     * @brief Результаты последнего run() в порядке добавления микросхем.
+     */
+    const std::vector<ChipResult> &results() const { return results_; }
+
+    /**
+     * @brief Общее время последнего run(), мкс.
+     */
+    uint64_t totalTimeUs() const { return totalTimeUs_; }
+
+private:
+    std::vector<std::vector<EEPROMShadow *>> buses_;
+    std::vector<ChipResult> results_;
+    uint64_t totalTimeUs_;
+};
+
+#endif // EEPROM_STARTUP_LOADER_HPP
@@ -0,0 +1,280 @@
+#ifndef EEPROM_TIMESERIES_LOG_HPP
+#define EEPROM_TIMESERIES_LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+
+/**
+ * @file eeprom_timeseries_log.hpp
+ * @brief Кольцевой журнал отсчётов (время, значение) со сжатием.
+ *
+ * Журнал занимает непрерывную группу страниц; одна страница - один блок.
+ * Формат блока (16 байт):
+ *  - байт 0: порядковый номер блока (по модулю 256)
+ *  - байт 1: количество отсчётов в блоке
+ *  - байты 2..5: время первого отсчёта (little-endian)
+ *  - байты 6..7: значение первого отсчёта (int16, little-endian)
+ *  - байты 8..15: остальные отсчёты битовым потоком (см. eeprom_bitstream.hpp)
+ *
+ * Время кодируется разностью второго порядка (delta-of-delta, как в Gorilla):
+ *  - '0'               - интервал не изменился
+ *  - '10'   + 7 бит    - изменение в [-64, 63]
+ *  - '110'  + 9 бит    - изменение в [-256, 255]
+ *  - '1110' + 12 бит   - изменение в [-2048, 2047]
+ *  - '1111' + 32 бита  - любое изменение
+ *
+ * Значение - разностью с предыдущим:
+ *  - '0'              - не изменилось
+ *  - '10'  + 3 бита   - [-4, 3]
+ *  - '110' + 7 бит    - [-64, 63]
+ *  - '111' + 16 бит   - любое
+ *
+ * Числа со знаком хранятся в zigzag-представлении, префиксы пишутся
+ * по одному биту в порядке слева направо. Первый интервал блока
+ * кодируется относительно нуля, поэтому каждый блок декодируется
+ * независимо от остальных.
+ *
+ * Отсчёты накапливаются в RAM, и страница программируется, когда
+ * блок заполнен (или по flush()): один цикл tWC на блок.
+ *
+ * В RAM хранится разреженный индекс - время первого отсчёта каждого
+ * блока, а также количество, минимум и максимум его значений. Индекс
+ * строится в open() из одного чтения области журнала: время берётся
+ * из заголовка, сводка - декодированием уже прочитанного блока в RAM.
+ * На микросхеме сводка не хранится и места в странице не занимает;
+ * при добавлении сводка текущего блока обновляется без декодирования.
+ *
+ * query() читает только блоки, пересекающиеся с запрошенным интервалом;
+ * summarize() учитывает блоки, целиком лежащие в интервале, по индексу
+ * и читает только блоки на его границах. Индекс предполагает,
+ * что время отсчётов не убывает.
+ */
+
+/**
+ * @brief Сжатый кольцевой журнал отсчётов.
+ */
+class EEPROMTimeSeriesLog
+{
+public:
+    /**
+     * @brief Размер заголовка блока.
+     */
+    static constexpr std::size_t HEADER_SIZE = 8;
+
+    /**
+     * @brief Размер битового потока блока в битах.
+     */
+    static constexpr std::size_t PAYLOAD_BITS = (EEPROM25LC040A::PAGE_SIZE - HEADER_SIZE) * 8;
+
+    /**
+     * @brief Наибольшее количество страниц в кольце.
+     */
+    static constexpr std::size_t MAX_PAGES = EEPROM25LC040A::CAPACITY_BYTES / EEPROM25LC040A::PAGE_SIZE;
+
+    static_assert(MAX_PAGES <= 32, "маска блоков должна помещаться в uint32_t");
+
+    /**
+     * @brief Наибольшее количество отсчётов в блоке.
+     */
+    static constexpr std::size_t MAX_BLOCK_SAMPLES = 1 + PAYLOAD_BITS / 2;
+
+    /**
+     * @brief Отсчёт журнала.
+     */
+    struct Sample
+    {
+        uint32_t timestamp; ///< Время
+        int16_t value;      ///< Значение
+    };
+
+    /**
+     * @brief Сводка по отсчётам интервала.
+     */
+    struct Summary
+    {
+        std::size_t count; ///< Количество отсчётов
+        int16_t min;       ///< Наименьшее значение (при count > 0)
+        int16_t max;       ///< Наибольшее значение (при count > 0)
+    };
+
+    /**
+     * @brief Обработчик отсчёта при чтении журнала.
+     *
+     * @param sample  Отсчёт.
+     * @param context Пользовательский контекст.
+     */
+    using SampleCallback = void (*)(const Sample &sample, void *context);
+
+    /**
+     * @brief Конструктор.
+     *
+     * @param eeprom    Микросхема.
+     * @param firstPage Первая страница журнала.
+     * @param pageCount Количество страниц (блоков) в кольце.
+     */
+    EEPROMTimeSeriesLog(EEPROM25LC040A &eeprom, std::size_t firstPage, std::size_t pageCount);
+
+    /**
+     * @brief Найти последний блок на микросхеме и продолжить журнал с него.
+     *
+     * Если корректных блоков нет, журнал считается пустым.
+     */
+    void open();
+
+    /**
+     * @brief Добавить отсчёт.
+     *
+     * Если отсчёт не помещается в текущий блок, блок записывается
+     * на микросхему и начинается следующий (самый старый блок
+     * кольца при этом затирается).
+     *
+     * @return false, если журнал не настроен (нет страниц).
+     */
+    bool append(uint32_t timestamp, int16_t value);
+
+    /**
+     * @brief Записать текущий (неполный) блок на микросхему.
+     *
+     * Следующие отсчёты продолжат тот же блок, и страница будет
+     * записана ещё раз.
+     *
+     * @return true, если страница была записана.
+     */
+    bool flush();
+
+    /**
+     * @brief Перебрать все отсчёты от старых к новым.
+     *
+     * Включает ещё не записанные отсчёты текущего блока.
+     *
+     * @return Количество отсчётов.
+     */
+    std::size_t forEach(SampleCallback callback, void *context) const;
+
+    /**
+     * @brief Перебрать отсчёты с временем в интервале [from, to].
+     *
+     * С микросхемы читаются только блоки, которые по индексу
+     * могут содержать отсчёты из интервала.
+     *
+     * @param from     Начало интервала (включительно).
+     * @param to       Конец интервала (включительно).
+     * @param callback Обработчик.
+     * @param context  Контекст обработчика.
+     * @return Количество отсчётов в интервале.
+     */
+    std::size_t query(uint32_t from, uint32_t to, SampleCallback callback, void *context) const;
+
+    /**
+     * @brief Количество, минимум и максимум значений в интервале [from, to].
+     *
+     * Блоки, целиком лежащие в интервале, учитываются по индексу в RAM
+     * без обращения к микросхеме. Читаются и декодируются только блоки,
+     * пересекающие границы интервала (не более двух).
+     *
+     * @param from Начало интервала (включительно).
+     * @param to   Конец интервала (включительно).
+     * @return Сводка; count == 0, если отсчётов нет.
+     */
+    Summary summarize(uint32_t from, uint32_t to) const;
+
+    /**
+     * @brief Сколько страниц прочитал последний query() или summarize().
+     */
+    std::size_t lastQueryPages() const { return lastQueryPages_; }
+
+private:
+    static constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+
+    /**
+     * @brief Состояние кодера, нужное для следующего отсчёта.
+     */
+    struct CodecState
+    {
+        uint32_t timestamp; ///< Время последнего отсчёта
+        uint32_t delta;     ///< Последний интервал (по модулю 2^32)
+        uint16_t value;     ///< Последнее значение
+        std::size_t bits;   ///< Занято бит потока
+    };
+
+    /**
+     * @brief Сводка блока в индексе.
+     */
+    struct BlockSummary
+    {
+        int16_t min;
+        int16_t max;
+        uint8_t count;
+    };
+
+    /**
+     * @brief Корректен ли заголовок блока.
+     */
+    static bool isValidHeader(const uint8_t *block);
+
+    /**
+     * @brief Декодировать блок.
+     *
+     * @param block    Страница блока.
+     * @param callback Обработчик (может быть nullptr).
+     * @param context  Контекст обработчика.
+     * @param state    Если не nullptr - состояние после последнего отсчёта.
+     * @return Количество отсчётов; 0, если блок повреждён.
+     */
+    static std::size_t decodeBlock(const uint8_t *block,
+                                   SampleCallback callback,
+                                   void *context,
+                                   CodecState *state);
+
+    /**
+     * @brief Блок целиком лежит в интервале [from, to] (по индексу).
+     */
+    bool coveredBy(std::size_t index, uint32_t from, uint32_t to) const;
+
+    /**
+     * @brief Блок может содержать отсчёты из интервала [from, to] (по индексу).
+     */
+    bool overlaps(std::size_t index, uint32_t from, uint32_t to) const;
+
+    /**
+     * @brief Прочитать блок кольца: с микросхемы или текущий из RAM.
+     */
+    void readBlock(std::size_t index, uint8_t *block) const;
+
+    /**
+     * @brief Занести блок в индекс: время по заголовку, сводку декодированием.
+     */
+    void indexBlock(std::size_t index, const uint8_t *block);
+
+    /**
+     * @brief Начать новый блок с отсчёта.
+     */
+    void startBlock(uint32_t timestamp, int16_t value);
+
+    /**
+     * @brief Адрес страницы кольца.
+     */
+    std::size_t pageAddress(std::size_t index) const;
+
+private:
+    EEPROM25LC040A &eeprom_;
+    std::size_t firstPage_;
+    std::size_t pageCount_;
+
+    // Текущий блок в RAM
+    uint8_t block_[PAGE];
+    CodecState state_;
+    std::size_t head_; ///< Страница текущего блока (номер в кольце)
+    uint8_t sequence_; ///< Порядковый номер текущего блока
+    bool hasBlock_;
+    bool dirty_;       ///< Текущий блок отличается от записанного
+
+    // Разреженный индекс блоков текущего кольца: время первого отсчёта и сводка
+    uint32_t blockStart_[MAX_PAGES];
+    BlockSummary summaries_[MAX_PAGES];
+    uint32_t indexed_; ///< Маска страниц с действующими блоками
+    mutable std::size_t lastQueryPages_;
+};
+
+#endif // EEPROM_TIMESERIES_LOG_HPP
@@ -0,0 +1,137 @@
+#ifndef EEPROM_TRACE_HPP
+#define EEPROM_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_operation_listener.hpp"
+
+/**
+ * @file eeprom_trace.hpp
+ * @brief Запись и воспроизведение трасс операций EEPROM25LC040A.
+ *
+ * Формат трассы (двоичный, компактный):
+ *  - заголовок: 4 байта "ETR1"
+ *  - запись: байт операции (биты 0..4 - EEPROMOperation,
+ *    биты 5..7 - смещение в битах), затем LEB128-числа:
+ *    адрес, длина, приращение времени в микросекундах
+ *
+ * Типичная запись занимает 4-6 байт. Данные записей не сохраняются.
+ */
+
+/**
+ * @brief Одна запись трассы.
+ */
+struct EEPROMTraceRecord
+{
+    EEPROMOperationInfo info; ///< Операция
+    uint64_t timestampUs;     ///< Время от начала трассы, мкс
+};
+
+/**
+ * @brief Регистратор трассы в буфер в RAM.
+ *
+ * Подключается к EEPROM25LC040A через addListener(). Не выделяет
+ * память: при переполнении буфера записи отбрасываются,
+ * и выставляется признак overflowed().
+ */
+class EEPROMTraceRecorder : public EEPROMOperationListener
+{
+public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param buffer   Буфер для трассы.
+     * @param capacity Размер буфера в байтах.
+     * @param clock    Источник времени (nullptr - время не записывается).
+     */
+    EEPROMTraceRecorder(uint8_t *buffer, std::size_t capacity, EEPROMClockFunction clock);
+
+    void onOperationBegin(const EEPROMOperationInfo &info) override;
+    void onOperationEnd(const EEPROMOperationInfo &) override {}
+
+    /**
+     * @brief Начать трассу заново.
+     */
+    void clear();
+
+    /**
+     * @brief Данные трассы.
+     */
+    const uint8_t *data() const { return buffer_; }
+
+    /**
+     * @brief Размер трассы в байтах.
+     */
+    std::size_t size() const { return size_; }
+
+    /**
+     * @brief Были ли отброшены записи из-за нехватки места.
+     */
+    bool overflowed() const { return overflowed_; }
+
+private:
+    uint8_t *buffer_;
+    std::size_t capacity_;
+    std::size_t size_;
+    bool overflowed_;
+    EEPROMClockFunction clock_;
+    uint32_t lastTimestamp_;
+};
+
+/**
+ * @brief Чтение трассы.
+ */
+class EEPROMTraceReader
+{
+public:
+    /**
+     * @brief Конструктор.
+     *
+     * @param data Данные трассы.
+     * @param size Размер в байтах.
+     */
+    EEPROMTraceReader(const uint8_t *data, std::size_t size);
+
+    /**
+     * @brief Корректен ли заголовок трассы.
+     */
+    bool valid() const { return valid_; }
+
+    /**
+     * @brief Прочитать следующую запись.
+     *
+     * @return false, если записи закончились или трасса повреждена.
+     */
+    bool next(EEPROMTraceRecord &record);
+
+    /**
+     * @brief Вернуться к первой записи.
+     */
+    void rewind();
+
+private:
+    bool readVarint(uint64_t &value);
+
+private:
+    const uint8_t *data_;
+    std::size_t size_;
+    std::size_t position_;
+    bool valid_;
+    uint64_t timestampUs_;
+};
+
+/**
+ * @brief Воспроизвести трассу на микросхеме (реальной или симуляторе).
+ *
+ * Данные записей в трассе не хранятся, поэтому записывается
+ * заполнитель. Операции над полями воспроизводятся как
+ * readArray / writeArray покрывающего диапазона.
+ *
+ * @param reader Трасса.
+ * @param eeprom Микросхема.
+ * @return Количество воспроизведённых записей.
+ */
+std::size_t replayTrace(EEPROMTraceReader &reader, EEPROM25LC040A &eeprom);
+
+#endif // EEPROM_TRACE_HPP
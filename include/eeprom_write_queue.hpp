@@ -0,0 +1,211 @@
+#ifndef EEPROM_WRITE_QUEUE_HPP
+#define EEPROM_WRITE_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "eeprom_25lc040a.hpp"
+
+/**
+ * @file eeprom_write_queue.hpp
+ * @brief Очередь запросов записи в EEPROM для потоков реального времени.
+ *
+ * Кольцевой буфер с одним производителем и одним потребителем (SPSC):
+ *  - производитель (поток реального времени, обработчик прерывания)
+ *    копирует данные в заранее выделенный слот и никогда не ждёт
+ *  - потребитель (фоновая задача) объединяет запросы по страницам
+ *    и выполняет запись через writeArray
+ */
+
+/**
+ * @brief Очередь запросов записи без блокировок (SPSC).
+ *
+ * tryPush() не выделяет память, не берёт блокировок и не ждёт tWC:
+ * это одно копирование в слот и одна атомарная запись индекса.
+ * Если очередь заполнена, запрос отклоняется.
+ *
+ * drain() собирает подряд идущие запросы к одной странице в буфере
+ * страницы и программирует её один раз. Если между изменёнными
+ * байтами есть пропуски, недостающие байты дочитываются одним кадром.
+ *
+ * @tparam Capacity Количество слотов (степень двойки).
+ * @tparam SlotSize Максимальная длина данных одного запроса.
+ */
+template <std::size_t Capacity, std::size_t SlotSize = EEPROM25LC040A::PAGE_SIZE>
+class EEPROMWriteQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "ёмкость очереди должна быть степенью двойки");
+    static_assert(SlotSize > 0 && SlotSize <= 0xFF,
+                  "длина данных слота хранится в одном байте");
+
+public:
+    /**
+     * @brief Поставить запрос записи в очередь (только производитель).
+     *
+     * @param address Начальный адрес.
+     * @param data    Данные (копируются в слот).
+     * @param length  Количество байт (не более SlotSize).
+     * @return false, если очередь заполнена или запрос некорректен.
+     */
+    bool tryPush(std::size_t address, const uint8_t *data, std::size_t length)
+    {
+        if (data == nullptr || length == 0 || length > SlotSize ||
+            address + length > EEPROM25LC040A::CAPACITY_BYTES)
+        {
+            return false;
+        }
+
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity)
+        {
+            return false; // Очередь заполнена
+        }
+
+        Slot &slot = slots_[tail & (Capacity - 1)];
+        slot.address = static_cast<uint16_t>(address);
+        slot.length = static_cast<uint8_t>(length);
+        std::memcpy(slot.data, data, length);
+
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Пуста ли очередь.
+     */
+    bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Выполнить накопленные запросы (только потребитель).
+     *
+     * @param eeprom Микросхема.
+     * @return Количество обработанных запросов.
+     */
+    std::size_t drain(EEPROM25LC040A &eeprom)
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+
+        PageStage stage{};
+
+        for (std::size_t i = head; i != tail; ++i)
+        {
+            const Slot &slot = slots_[i & (Capacity - 1)];
+
+            // Запрос может пересекать границу страницы
+            std::size_t address = slot.address;
+            std::size_t offset = 0;
+            while (offset < slot.length)
+            {
+                const std::size_t page = address / PAGE;
+                const std::size_t chunk = std::min<std::size_t>(slot.length - offset,
+                                                                PAGE - address % PAGE);
+
+                if (stage.used && stage.page != page)
+                {
+                    commit(eeprom, stage);
+                }
+                stage.used = true;
+                stage.page = page;
+
+                for (std::size_t b = 0; b < chunk; ++b)
+                {
+                    stage.data[address % PAGE + b] = slot.data[offset + b];
+                    stage.mask[address % PAGE + b] = true;
+                }
+
+                address += chunk;
+                offset += chunk;
+            }
+        }
+
+        if (stage.used)
+        {
+            commit(eeprom, stage);
+        }
+
+        // Слоты освобождаются только после записи их данных
+        head_.store(tail, std::memory_order_release);
+        return tail - head;
+    }
+
+private:
+    static constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+
+    /**
+     * @brief Слот запроса.
+     */
+    struct Slot
+    {
+        uint16_t address;
+        uint8_t length;
+        uint8_t data[SlotSize];
+    };
+
+    /**
+     * @brief Накопленные изменения одной страницы.
+     */
+    struct PageStage
+    {
+        bool used;
+        std::size_t page;
+        uint8_t data[PAGE];
+        bool mask[PAGE];
+    };
+
+    /**
+     * @brief Запрограммировать накопленную страницу одним кадром WRITE.
+     */
+    static void commit(EEPROM25LC040A &eeprom, PageStage &stage)
+    {
+        std::size_t first = 0;
+        while (!stage.mask[first])
+        {
+            ++first;
+        }
+        std::size_t last = PAGE - 1;
+        while (!stage.mask[last])
+        {
+            --last;
+        }
+
+        const std::size_t base = stage.page * PAGE;
+
+        // Пропуски внутри участка заполняем текущим содержимым микросхемы
+        bool gaps = false;
+        for (std::size_t i = first; i <= last; ++i)
+        {
+            gaps = gaps || !stage.mask[i];
+        }
+        if (gaps)
+        {
+            uint8_t current[PAGE];
+            eeprom.readArray(base + first, current, last - first + 1);
+            for (std::size_t i = first; i <= last; ++i)
+            {
+                if (!stage.mask[i])
+                {
+                    stage.data[i] = current[i - first];
+                }
+            }
+        }
+
+        eeprom.writeArray(base + first, stage.data + first, last - first + 1);
+        stage = PageStage{};
+    }
+
+private:
+    Slot slots_[Capacity];
+
+    // Индексы на разных кеш-линиях, чтобы потоки не мешали друг другу
+    alignas(64) std::atomic<std::size_t> head_{0}; ///< Пишет только потребитель
+    alignas(64) std::atomic<std::size_t> tail_{0}; ///< Пишет только производитель
+};
+
+#endif // EEPROM_WRITE_QUEUE_HPP
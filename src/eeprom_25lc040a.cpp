@@ -1,27 +1,268 @@
 #include "eeprom_25lc040a.hpp"
 #include <algorithm>
+#include <cstring>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // Запас в конце буфера, чтобы читать 64-битное слово у последнего байта
+    constexpr std::size_t WORD_SLACK = sizeof(uint64_t);
+
+    /**
+     * @brief Загрузить 64-битное слово (младший байт первым).
+     */
+    uint64_t loadWord(const uint8_t *bytes)
+    {
+        uint64_t word = 0;
+        for (std::size_t i = 0; i < sizeof(uint64_t); ++i)
+        {
+            word |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        }
+        return word;
+    }
+
+    /**
+     * @brief Сохранить 64-битное слово (младший байт первым).
+     */
+    void storeWord(uint8_t *bytes, uint64_t word)
+    {
+        for (std::size_t i = 0; i < sizeof(uint64_t); ++i)
+        {
+            bytes[i] = static_cast<uint8_t>(word >> (8 * i));
+        }
+    }
+
+    /**
+     * @brief Извлечь биты по маске (PEXT).
+     */
+    uint64_t extractBits(uint64_t word, uint64_t mask, unsigned shift)
+    {
+#if defined(__BMI2__)
+        return _pext_u64(word, mask << shift);
+#else
+        return (word >> shift) & mask;
+#endif
+    }
+
+    /**
+     * @brief Вставить биты по маске (PDEP).
+     */
+    uint64_t depositBits(uint64_t word, uint64_t value, uint64_t mask, unsigned shift)
+    {
+#if defined(__BMI2__)
+        return (word & ~(mask << shift)) | _pdep_u64(value, mask << shift);
+#else
+        return (word & ~(mask << shift)) | ((value & mask) << shift);
+#endif
+    }
+
+    /**
+     * @brief Проверить, что поле корректно и лежит внутри микросхемы.
+     */
+    bool isValidField(const EEPROM25LC040A::BitField &field)
+    {
+        if (field.bitCount == 0 || field.bitCount > 32)
+        {
+            return false;
+        }
+        const std::size_t last_bit = field.bitOffset + field.bitCount - 1;
+        return field.address + last_bit / 8 < EEPROM25LC040A::CAPACITY_BYTES;
+    }
+
+    /**
+     * @brief Байты [begin, end], которые занимает поле.
+     */
+    void fieldRange(const EEPROM25LC040A::BitField &field, std::size_t &begin, std::size_t &end)
+    {
+        begin = field.address + field.bitOffset / 8;
+        end = field.address + (field.bitOffset + field.bitCount - 1) / 8;
+    }
+
+    /**
+     * @brief Найти диапазон байт [first, last], покрывающий все поля.
+     *
+     * @return false, если корректных полей нет.
+     */
+    bool coveringRange(const EEPROM25LC040A::BitField *fields,
+                       std::size_t count,
+                       std::size_t &first,
+                       std::size_t &last)
+    {
+        bool found = false;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (!isValidField(fields[i]))
+            {
+                continue;
+            }
+            std::size_t begin = 0;
+            std::size_t end = 0;
+            fieldRange(fields[i], begin, end);
+            first = found ? std::min(first, begin) : begin;
+            last = found ? std::max(last, end) : end;
+            found = true;
+        }
+        return found;
+    }
+
+    /**
+     * @brief Окно обработки полей [begin, end) длиной не больше MAX_FIELD_SPAN.
+     *
+     * Окно обрабатывает поля, которые в нём целиком и начинаются не раньше
+     * begin. Следующее окно начинается с первого необработанного поля,
+     * так что каждое поле попадает ровно в одно окно.
+     */
+    struct FieldWindow
+    {
+        std::size_t begin;
+        std::size_t end;
+
+        /**
+         * @brief Входит ли поле в окно.
+         */
+        bool contains(const EEPROM25LC040A::BitField &field) const
+        {
+            std::size_t first = 0;
+            std::size_t last = 0;
+            fieldRange(field, first, last);
+            return first >= begin && last < end;
+        }
+
+        /**
+         * @brief Перейти к следующему окну.
+         *
+         * @return false, если необработанных полей не осталось.
+         */
+        bool advance(const EEPROM25LC040A::BitField *fields, std::size_t count, std::size_t last)
+        {
+            bool found = false;
+            std::size_t next = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                std::size_t first = 0;
+                std::size_t field_last = 0;
+                fieldRange(fields[i], first, field_last);
+                if (isValidField(fields[i]) && first >= begin && field_last >= end)
+                {
+                    next = found ? std::min(next, first) : first;
+                    found = true;
+                }
+            }
+
+            begin = next;
+            end = std::min(begin + EEPROM25LC040A::MAX_FIELD_SPAN, last + 1);
+            return found;
+        }
+    };
+}
+
+/**
+ * @brief Добавить наблюдателя за операциями.
+ */
+bool EEPROM25LC040A::addListener(EEPROMOperationListener *listener)
+{
+    for (EEPROMOperationListener *&slot : listeners_)
+    {
+        if (slot == nullptr)
+        {
+            slot = listener;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Удалить наблюдателя.
+ */
+void EEPROM25LC040A::removeListener(EEPROMOperationListener *listener)
+{
+    for (EEPROMOperationListener *&slot : listeners_)
+    {
+        if (slot == listener)
+        {
+            slot = nullptr;
+        }
+    }
+}
+
+/**
+ * @brief Сообщить наблюдателям о начале операции.
+ */
+void EEPROM25LC040A::beginOperation(const EEPROMOperationInfo &info) const
+{
+    // Сообщаем только о внешних вызовах
+    if (depth_++ != 0)
+    {
+        return;
+    }
+
+    for (EEPROMOperationListener *listener : listeners_)
+    {
+        if (listener != nullptr)
+        {
+            listener->onOperationBegin(info);
+        }
+    }
+}
+
+/**
+ * @brief Сообщить наблюдателям о конце операции.
+ */
+void EEPROM25LC040A::endOperation(const EEPROMOperationInfo &info) const
+{
+    if (--depth_ != 0)
+    {
+        return;
+    }
+
+    for (EEPROMOperationListener *listener : listeners_)
+    {
+        if (listener != nullptr)
+        {
+            listener->onOperationEnd(info);
+        }
+    }
+}
+
+EEPROM25LC040A::OperationScope::OperationScope(const EEPROM25LC040A &eeprom,
+                                               const EEPROMOperationInfo &info)
+    : eeprom_(eeprom), info_(info)
+{
+    eeprom_.beginOperation(info_);
+}
+
+EEPROM25LC040A::OperationScope::~OperationScope()
+{
+    eeprom_.endOperation(info_);
+}
 
 /**
  * @brief Прочитать один байт из EEPROM.
  */
 uint8_t EEPROM25LC040A::readByte(std::size_t address) const
 {
+    OperationScope scope(*this, {EEPROMOperation::READ_BYTE, address, 1, 0});
+
     // Опускаем CS
-    spi_.driver().cs_low();
+    select();
 
     // Команда READ. EEPROM понимает, что дальше будет адрес и чтение данных
-    spi_.transferByte(static_cast<uint8_t>(Opcode::READ));
+    transfer(static_cast<uint8_t>(Opcode::READ));
 
     // Передаём адрес (для 25LC040A используется 9-битный адрес, т. к. 512 байт,
     // но передаётся как 16 бит: старший байт первым)
-    spi_.transferByte(static_cast<uint8_t>((address >> 8) & 0xFF));
-    spi_.transferByte(static_cast<uint8_t>(address & 0xFF));
+    transfer(static_cast<uint8_t>((address >> 8) & 0xFF));
+    transfer(static_cast<uint8_t>(address & 0xFF));
 
     // Чтение данных (0xFF - фиктивный байт, так как полный дуплекс)
-    uint8_t value = spi_.transferByte(0xFF);
+    uint8_t value = transfer(0xFF);
 
     // Поднимаем CS
-    spi_.driver().cs_high();
+    deselect();
 
     return value;
 }
@@ -31,24 +272,27 @@ uint8_t EEPROM25LC040A::readByte(std::size_t address) const
  */
 void EEPROM25LC040A::writeByte(std::size_t address, uint8_t value)
 {
+    OperationScope scope(*this, {EEPROMOperation::WRITE_BYTE, address, 1, 0});
+
     // Разрешаем запись
     writeEnable();
 
     // Опускаем CS
-    spi_.driver().cs_low();
+    select();
 
     // Команда WRITE
-    spi_.transferByte(static_cast<uint8_t>(Opcode::WRITE));
+    transfer(static_cast<uint8_t>(Opcode::WRITE));
 
     // Передаём адрес
-    spi_.transferByte(static_cast<uint8_t>((address >> 8) & 0xFF));
-    spi_.transferByte(static_cast<uint8_t>(address & 0xFF));
+    transfer(static_cast<uint8_t>((address >> 8) & 0xFF));
+    transfer(static_cast<uint8_t>(address & 0xFF));
 
     // Данные
-    spi_.transferByte(value);
+    transfer(value);
 
     // Поднимаем CS - здесь начинается внутренняя запись
-    spi_.driver().cs_high();
+    deselect();
+    ++bus_.writeCycles;
 
     // Ждём окончания записи
     waitUntilWriteComplete();
@@ -60,31 +304,59 @@ void EEPROM25LC040A::writeByte(std::size_t address, uint8_t value)
 void EEPROM25LC040A::writeEnable()
 {
     // Опускаем CS
-    spi_.driver().cs_low();
+    select();
 
     // Команда EEPROM для установки защелки разрешения записи
-    spi_.transferByte(static_cast<uint8_t>(Opcode::WREN));
+    transfer(static_cast<uint8_t>(Opcode::WREN));
 
     // Поднимаем CS
+    deselect();
+}
+
+/**
+ * @brief Опустить CS (начать кадр).
+ */
+void EEPROM25LC040A::select() const
+{
+    ++bus_.frames;
+    spi_.driver().cs_low();
+}
+
+/**
+ * @brief Поднять CS (закончить кадр).
+ */
+void EEPROM25LC040A::deselect() const
+{
     spi_.driver().cs_high();
 }
 
+/**
+ * @brief Передать байт в текущем кадре.
+ */
+uint8_t EEPROM25LC040A::transfer(uint8_t value) const
+{
+    ++bus_.bytes;
+    return spi_.transferByte(value);
+}
+
 /**
  * @brief Прочитать регистр статуса.
  */
 uint8_t EEPROM25LC040A::readStatus() const
 {
     // Опускаем CS
-    spi_.driver().cs_low();
+    select();
+
+    ++bus_.statusPolls;
 
     // Команда EEPROM для чтения регистра статуса
-    spi_.transferByte(static_cast<uint8_t>(Opcode::RDSR));
+    transfer(static_cast<uint8_t>(Opcode::RDSR));
 
     // Получение регистра статуса
-    uint8_t status = spi_.transferByte(0xFF);
+    uint8_t status = transfer(0xFF);
 
     // Поднимаем CS
-    spi_.driver().cs_high();
+    deselect();
 
     return status;
 }
@@ -106,10 +378,43 @@ void EEPROM25LC040A::waitUntilWriteComplete() const
             break; // Запись завершена
         }
         // Небольшая пауза
-        spi_.driver().delay_us(10);
+        constexpr unsigned POLL_DELAY_US = 10;
+        spi_.driver().delay_us(POLL_DELAY_US);
+        bus_.delayUs += POLL_DELAY_US;
     }
 }
 
+/**
+ * @brief Начать запись страницы без ожидания tWC.
+ */
+void EEPROM25LC040A::beginPageWrite(std::size_t address,
+                                    const uint8_t *data,
+                                    std::size_t length)
+{
+    // Разрешаем запись
+    writeEnable();
+
+    // Опускаем CS
+    select();
+
+    // Команда WRITE
+    transfer(static_cast<uint8_t>(Opcode::WRITE));
+
+    // Адрес
+    transfer(static_cast<uint8_t>((address >> 8) & 0xFF));
+    transfer(static_cast<uint8_t>(address & 0xFF));
+
+    // Записываем данные страницы
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        transfer(data[i]);
+    }
+
+    // Поднимаем CS
+    deselect();
+    ++bus_.writeCycles;
+}
+
 /**
  * @brief Прочитать массив байт из EEPROM.
  */
@@ -122,24 +427,26 @@ void EEPROM25LC040A::readArray(std::size_t address,
         return;
     }
 
+    OperationScope scope(*this, {EEPROMOperation::READ_ARRAY, address, length, 0});
+
     // Опускаем CS
-    spi_.driver().cs_low();
+    select();
 
     // Команда READ
-    spi_.transferByte(static_cast<uint8_t>(Opcode::READ));
+    transfer(static_cast<uint8_t>(Opcode::READ));
 
     // Адрес
-    spi_.transferByte(static_cast<uint8_t>((address >> 8) & 0xFF));
-    spi_.transferByte(static_cast<uint8_t>(address & 0xFF));
+    transfer(static_cast<uint8_t>((address >> 8) & 0xFF));
+    transfer(static_cast<uint8_t>(address & 0xFF));
 
     // Читаем данные
     for (std::size_t i = 0; i < length; ++i)
     {
-        buffer[i] = spi_.transferByte(0xFF);
+        buffer[i] = transfer(0xFF);
     }
 
     // Поднимаем CS
-    spi_.driver().cs_high();
+    deselect();
 }
 
 /**
@@ -149,11 +456,114 @@ void EEPROM25LC040A::writeArray(std::size_t address,
                                 const uint8_t *buffer,
                                 std::size_t length)
 {
+    writePages(address, buffer, length, nullptr);
+}
+
+/**
+ * @brief Записать массив байт с возможностью отмены.
+ */
+OperationProgress EEPROM25LC040A::writeArray(std::size_t address,
+                                             const uint8_t *buffer,
+                                             std::size_t length,
+                                             const CancellationToken &token)
+{
+    return writePages(address, buffer, length, &token);
+}
+
+/**
+ * @brief Прочитать массив байт с возможностью отмены.
+ */
+OperationProgress EEPROM25LC040A::readArray(std::size_t address,
+                                            uint8_t *buffer,
+                                            std::size_t length,
+                                            const CancellationToken &token) const
+{
+    OperationProgress progress{0, length, false};
     if (buffer == nullptr || length == 0)
     {
-        return;
+        return progress;
     }
 
+    OperationScope scope(*this, {EEPROMOperation::READ_ARRAY, address, length, 0});
+
+    while (progress.completed < length)
+    {
+        if (token.isCancelled())
+        {
+            progress.cancelled = true;
+            break;
+        }
+
+        const std::size_t chunk = std::min(CANCEL_CHUNK, length - progress.completed);
+        readArray(address + progress.completed, buffer + progress.completed, chunk);
+        progress.completed += chunk;
+    }
+
+    return progress;
+}
+
+/**
+ * @brief Сравнить содержимое EEPROM с ожидаемыми данными.
+ */
+bool EEPROM25LC040A::verifyArray(std::size_t address,
+                                 const uint8_t *expected,
+                                 std::size_t length,
+                                 const CancellationToken *token,
+                                 OperationProgress *progress) const
+{
+    OperationProgress result{0, length, false};
+    bool matched = expected != nullptr || length == 0;
+
+    if (expected != nullptr && length > 0)
+    {
+        OperationScope scope(*this, {EEPROMOperation::READ_ARRAY, address, length, 0});
+
+        uint8_t chunk_data[CANCEL_CHUNK];
+        while (result.completed < length)
+        {
+            if (token != nullptr && token->isCancelled())
+            {
+                result.cancelled = true;
+                matched = false;
+                break;
+            }
+
+            const std::size_t chunk = std::min(CANCEL_CHUNK, length - result.completed);
+            readArray(address + result.completed, chunk_data, chunk);
+
+            const uint8_t *want = expected + result.completed;
+            const std::size_t same = static_cast<std::size_t>(
+                std::mismatch(chunk_data, chunk_data + chunk, want).first - chunk_data);
+            result.completed += same;
+
+            if (same != chunk)
+            {
+                matched = false;
+                break;
+            }
+        }
+    }
+
+    if (progress != nullptr)
+    {
+        *progress = result;
+    }
+    return matched;
+}
+
+OperationProgress EEPROM25LC040A::writePages(std::size_t address,
+                                             const uint8_t *buffer,
+                                             std::size_t length,
+                                             const CancellationToken *token)
+{
+    OperationProgress progress{0, length, false};
+    if (buffer == nullptr || length == 0)
+    {
+        return progress;
+    }
+
+    OperationScope scope(*this, {EEPROMOperation::WRITE_ARRAY, address, length, 0});
+
     // remainnig - сколько ещё байт нужно записать
     std::size_t remaining = length;
 
@@ -162,6 +572,13 @@ void EEPROM25LC040A::writeArray(std::size_t address,
 
     while (remaining > 0)
     {
+        // Отмена - только на границе страницы, предыдущая уже записана целиком
+        if (token != nullptr && token->isCancelled())
+        {
+            progress.cancelled = true;
+            break;
+        }
+
         // Сколько байт можно записать в текущую страницу (размер страницы 16 байт)
         std::size_t page_offset = address % PAGE_SIZE;
         std::size_t bytes_in_page = PAGE_SIZE - page_offset;
@@ -169,27 +586,8 @@ void EEPROM25LC040A::writeArray(std::size_t address,
                                 ? remaining
                                 : bytes_in_page;
 
-        // Разрешаем запись
-        writeEnable();
-
-        // Опускаем CS
-        spi_.driver().cs_low();
-
-        // Команда WRITE
-        spi_.transferByte(static_cast<uint8_t>(Opcode::WRITE));
-
-        // Адрес
-        spi_.transferByte(static_cast<uint8_t>((address >> 8) & 0xFF));
-        spi_.transferByte(static_cast<uint8_t>(address & 0xFF));
-
-        // Записываем данные страницы
-        for (std::size_t i = 0; i < chunk; ++i)
-        {
-            spi_.transferByte(buffer[offset + i]);
-        }
-
-        // Поднимаем CS
-        spi_.driver().cs_high();
+        // Передаём страницу
+        beginPageWrite(address, buffer + offset, chunk);
 
         // Ждём окончания записи страницы
         waitUntilWriteComplete();
@@ -199,6 +597,9 @@ void EEPROM25LC040A::writeArray(std::size_t address,
         offset += chunk;
         remaining -= chunk;
     }
+
+    progress.completed = offset;
+    return progress;
 }
 
 bool EEPROM25LC040A::readBit(std::size_t address, unsigned bit) const
@@ -221,6 +622,8 @@ uint32_t EEPROM25LC040A::readBits(std::size_t address,
         return 0;
     }
 
+    OperationScope scope(*this, {EEPROMOperation::READ_BITS, address, bitCount, bitOffset});
+
     uint32_t result = 0;             // Собираем биты
     unsigned bits_read = 0;          // Сколько бит прочитали
     std::size_t byte_addr = address; // Адрес текущего байта EEPROM
@@ -263,6 +666,8 @@ void EEPROM25LC040A::writeBits(std::size_t address,
         return;
     }
 
+    OperationScope scope(*this, {EEPROMOperation::WRITE_BITS, address, bitCount, bitOffset});
+
     unsigned bits_written = 0;       // Сколько бит записали
     std::size_t byte_addr = address; // Адрес текущего байта
 
@@ -292,3 +697,313 @@ void EEPROM25LC040A::writeBits(std::size_t address,
         ++byte_addr;
     }
 }
+
+/**
+ * @brief Записать одинаковые данные сразу в несколько микросхем.
+ */
+void EEPROM25LC040A::broadcastWriteArray(EEPROM25LC040A *const *chips,
+                                         std::size_t count,
+                                         std::size_t address,
+                                         const uint8_t *buffer,
+                                         std::size_t length)
+{
+    if (chips == nullptr || count == 0 || buffer == nullptr || length == 0)
+    {
+        return;
+    }
+
+    // Для каждой микросхемы это одна операция WRITE_ARRAY
+    const EEPROMOperationInfo info{EEPROMOperation::WRITE_ARRAY, address, length, 0};
+    for (std::size_t c = 0; c < count; ++c)
+    {
+        chips[c]->beginOperation(info);
+    }
+
+    // Общие линии SCLK и MOSI тактируем через первую микросхему,
+    // байт общего кадра принимают (и учитывают) все микросхемы
+    const EEPROM25LC040A &bus = *chips[0];
+    auto send = [&](uint8_t value) {
+        bus.transfer(value);
+        for (std::size_t c = 1; c < count; ++c)
+        {
+            ++chips[c]->bus_.bytes;
+        }
+    };
+
+    std::size_t remaining = length;
+    std::size_t offset = 0;
+
+    while (remaining > 0)
+    {
+        // Размер куска в пределах текущей страницы
+        std::size_t page_offset = address % PAGE_SIZE;
+        std::size_t bytes_in_page = PAGE_SIZE - page_offset;
+        std::size_t chunk = (remaining < bytes_in_page)
+                                ? remaining
+                                : bytes_in_page;
+
+        // Разрешаем запись во всех микросхемах одним кадром WREN
+        for (std::size_t c = 0; c < count; ++c)
+        {
+            chips[c]->select();
+        }
+        send(static_cast<uint8_t>(Opcode::WREN));
+        for (std::size_t c = 0; c < count; ++c)
+        {
+            chips[c]->deselect();
+        }
+
+        // Кадр WRITE для всех микросхем сразу
+        for (std::size_t c = 0; c < count; ++c)
+        {
+            chips[c]->select();
+        }
+
+        send(static_cast<uint8_t>(Opcode::WRITE));
+        send(static_cast<uint8_t>((address >> 8) & 0xFF));
+        send(static_cast<uint8_t>(address & 0xFF));
+
+        for (std::size_t i = 0; i < chunk; ++i)
+        {
+            send(buffer[offset + i]);
+        }
+
+        // Поднимаем CS - во всех микросхемах одновременно начинается запись
+        for (std::size_t c = 0; c < count; ++c)
+        {
+            chips[c]->deselect();
+            ++chips[c]->bus_.writeCycles;
+        }
+
+        // WIP проверяем у каждой микросхемы отдельно (по одной CS)
+        for (std::size_t c = 0; c < count; ++c)
+        {
+            chips[c]->waitUntilWriteComplete();
+        }
+
+        address += chunk;
+        offset += chunk;
+        remaining -= chunk;
+    }
+
+    for (std::size_t c = count; c > 0; --c)
+    {
+        chips[c - 1]->endOperation(info);
+    }
+}
+
+void EEPROM25LC040A::readFields(const BitField *fields,
+                                std::size_t count,
+                                uint32_t *values) const
+{
+    if (fields == nullptr || values == nullptr || count == 0)
+    {
+        return;
+    }
+
+    std::fill(values, values + count, 0u);
+
+    std::size_t first = 0;
+    std::size_t last = 0;
+    if (!coveringRange(fields, count, first, last))
+    {
+        return;
+    }
+
+    OperationScope scope(*this, {EEPROMOperation::READ_FIELDS, first, last - first + 1, 0});
+
+    FieldWindow window{first, std::min(first + MAX_FIELD_SPAN, last + 1)};
+    do
+    {
+        // Окно читаем одним кадром
+        uint8_t bytes[MAX_FIELD_SPAN + WORD_SLACK] = {};
+        readArray(window.begin, bytes, window.end - window.begin);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const BitField &field = fields[i];
+            if (!isValidField(field) || !window.contains(field))
+            {
+                continue;
+            }
+
+            // Позиция поля в битах от начала окна
+            const std::size_t bit_pos = (field.address - window.begin) * 8 + field.bitOffset;
+            const uint64_t word = loadWord(bytes + bit_pos / 8);
+            const uint64_t mask = (uint64_t{1} << field.bitCount) - 1;
+
+            values[i] = static_cast<uint32_t>(extractBits(word, mask, bit_pos % 8));
+        }
+    } while (window.advance(fields, count, last));
+}
+
+void EEPROM25LC040A::writeFields(const BitField *fields,
+                                 std::size_t count,
+                                 const uint32_t *values)
+{
+    if (fields == nullptr || values == nullptr || count == 0)
+    {
+        return;
+    }
+
+    std::size_t first = 0;
+    std::size_t last = 0;
+    if (!coveringRange(fields, count, first, last))
+    {
+        return;
+    }
+
+    OperationScope scope(*this, {EEPROMOperation::WRITE_FIELDS, first, last - first + 1, 0});
+
+    FieldWindow window{first, std::min(first + MAX_FIELD_SPAN, last + 1)};
+    do
+    {
+        // Текущее содержимое окна - одним кадром
+        const std::size_t length = window.end - window.begin;
+        uint8_t bytes[MAX_FIELD_SPAN + WORD_SLACK] = {};
+        readArray(window.begin, bytes, length);
+
+        uint8_t original[MAX_FIELD_SPAN];
+        std::memcpy(original, bytes, length);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const BitField &field = fields[i];
+            if (!isValidField(field) || !window.contains(field))
+            {
+                continue;
+            }
+
+            const std::size_t bit_pos = (field.address - window.begin) * 8 + field.bitOffset;
+            const uint64_t mask = (uint64_t{1} << field.bitCount) - 1;
+            uint8_t *at = bytes + bit_pos / 8;
+
+            storeWord(at, depositBits(loadWord(at), values[i], mask, bit_pos % 8));
+        }
+
+        // Каждую страницу с изменёнными байтами программируем один раз:
+        // от первого до последнего изменённого байта внутри страницы
+        std::size_t i = 0;
+        while (i < length)
+        {
+            if (bytes[i] == original[i])
+            {
+                ++i;
+                continue;
+            }
+
+            const std::size_t page_end =
+                std::min(length, (window.begin + i) / PAGE_SIZE * PAGE_SIZE + PAGE_SIZE - window.begin);
+
+            std::size_t span_end = i + 1;
+            for (std::size_t j = i + 1; j < page_end; ++j)
+            {
+                if (bytes[j] != original[j])
+                {
+                    span_end = j + 1;
+                }
+            }
+
+            writeArray(window.begin + i, bytes + i, span_end - i);
+            i = page_end;
+        }
+    } while (window.advance(fields, count, last));
+}
+
+/**
+ * @brief Скопировать диапазон из одной микросхемы в другую.
+ */
+OperationProgress EEPROM25LC040A::copyBetween(const EEPROM25LC040A &source,
+                                              std::size_t sourceAddress,
+                                              EEPROM25LC040A &destination,
+                                              std::size_t destinationAddress,
+                                              std::size_t length,
+                                              const CancellationToken *token)
+{
+    OperationProgress progress{0, length, false};
+    if (length == 0)
+    {
+        return progress;
+    }
+
+    const bool same_chip = &source == &destination;
+
+    OperationScope read_scope(source, {EEPROMOperation::READ_ARRAY, sourceAddress, length, 0});
+    OperationScope write_scope(destination, {EEPROMOperation::WRITE_ARRAY, destinationAddress, length, 0});
+
+    // Приёмник выше источника с перекрытием: страницами с конца (как memmove),
+    // чтобы запись не затирала ещё не скопированные байты источника
+    if (same_chip && sourceAddress < destinationAddress && destinationAddress < sourceAddress + length)
+    {
+        uint8_t page[PAGE_SIZE];
+        std::size_t end = length;
+        while (end > 0)
+        {
+            if (token != nullptr && token->isCancelled())
+            {
+                progress.cancelled = true;
+                break;
+            }
+
+            const std::size_t page_start = (destinationAddress + end - 1) / PAGE_SIZE * PAGE_SIZE;
+            const std::size_t offset = std::max(page_start, destinationAddress) - destinationAddress;
+            source.readArray(sourceAddress + offset, page, end - offset);
+            destination.beginPageWrite(destinationAddress + offset, page, end - offset);
+            destination.waitUntilWriteComplete();
+
+            progress.completed += end - offset;
+            end = offset;
+        }
+
+        return progress;
+    }
+
+    // Куски выравниваются по страницам приёмника
+    auto chunkAt = [&](std::size_t offset) {
+        const std::size_t bytes_in_page = PAGE_SIZE - (destinationAddress + offset) % PAGE_SIZE;
+        return std::min(bytes_in_page, length - offset);
+    };
+
+    // Два буфера: один передаётся в приёмник, в другой читается следующая страница
+    uint8_t pages[2][PAGE_SIZE];
+    unsigned current = 0;
+
+    std::size_t chunk = chunkAt(0);
+    source.readArray(sourceAddress, pages[current], chunk);
+
+    while (progress.completed < length)
+    {
+        if (token != nullptr && token->isCancelled())
+        {
+            progress.cancelled = true;
+            break;
+        }
+
+        destination.beginPageWrite(destinationAddress + progress.completed, pages[current], chunk);
+
+        // Пока приёмник в tWC, читаем следующую страницу из источника
+        const std::size_t next_offset = progress.completed + chunk;
+        std::size_t next_chunk = 0;
+        if (next_offset < length)
+        {
+            next_chunk = chunkAt(next_offset);
+            if (!same_chip)
+            {
+                source.readArray(sourceAddress + next_offset, pages[current ^ 1u], next_chunk);
+            }
+        }
+
+        destination.waitUntilWriteComplete();
+
+        if (same_chip && next_chunk != 0)
+        {
+            source.readArray(sourceAddress + next_offset, pages[current ^ 1u], next_chunk);
+        }
+
+        progress.completed = next_offset;
+        chunk = next_chunk;
+        current ^= 1u;
+    }
+
+    return progress;
+}
@@ -0,0 +1,286 @@
+#include "eeprom_25lc040a_simulator.hpp"
+#include <cstring>
+
+namespace
+{
+    // Коды команд (совпадают с EEPROM25LC040A::Opcode)
+    constexpr uint8_t OP_READ = 0x03;
+    constexpr uint8_t OP_WRITE = 0x02;
+    constexpr uint8_t OP_WREN = 0x06;
+    constexpr uint8_t OP_RDSR = 0x05;
+
+    // Биты регистра статуса
+    constexpr uint8_t STATUS_WIP = 0x01;
+    constexpr uint8_t STATUS_WEL = 0x02;
+}
+
+EEPROM25LC040ASimulator::EEPROM25LC040ASimulator(unsigned clockPeriodNs,
+                                                 unsigned writeCycleUs)
+    : clockPeriodNs_(clockPeriodNs),
+      writeCycleUs_(writeCycleUs),
+      stats_{},
+      nowNs_(0),
+      writeDoneNs_(0),
+      selected_(false),
+      mosi_(false),
+      miso_(true),
+      bitIndex_(0),
+      byteIndex_(0),
+      shiftIn_(0),
+      shiftOut_(0xFF),
+      opcode_(0),
+      address_(0),
+      writeEnabled_(false),
+      writeAccepted_(false),
+      page_{},
+      pageMask_{},
+      powerLossArmed_(false),
+      cyclesBeforeLoss_(0),
+      tornBytes_(0),
+      poweredOff_(false)
+{
+    // Чистая микросхема содержит 0xFF
+    std::memset(memory_, 0xFF, sizeof(memory_));
+}
+
+void EEPROM25LC040ASimulator::cs_low()
+{
+    selected_ = true;
+    bitIndex_ = 0;
+    byteIndex_ = 0;
+    shiftOut_ = 0xFF;
+    writeAccepted_ = false;
+    ++stats_.frames;
+}
+
+void EEPROM25LC040ASimulator::cs_high()
+{
+    if (!selected_)
+    {
+        return;
+    }
+    selected_ = false;
+
+    // Внутренняя запись начинается по фронту CS, если принят хотя бы один целый байт данных
+    if (writeAccepted_ && bitIndex_ == 0 && byteIndex_ > 3)
+    {
+        const std::size_t base = address_ / PAGE * PAGE;
+
+        if (powerLossArmed_ && cyclesBeforeLoss_ == 0)
+        {
+            // Питание пропало во время цикла: записано только начало кадра
+            const std::size_t received = byteIndex_ - 3 < PAGE ? byteIndex_ - 3 : PAGE;
+            for (std::size_t n = 0; n < received && n < tornBytes_; ++n)
+            {
+                const std::size_t offset = (address_ + n) % PAGE;
+                memory_[base + offset] = page_[offset];
+            }
+
+            powerLossArmed_ = false;
+            poweredOff_ = true;
+            writeEnabled_ = false;
+            writeAccepted_ = false;
+            return;
+        }
+
+        for (std::size_t i = 0; i < PAGE; ++i)
+        {
+            if (pageMask_[i])
+            {
+                memory_[base + i] = page_[i];
+            }
+        }
+
+        writeDoneNs_ = nowNs_ + static_cast<uint64_t>(writeCycleUs_) * 1000;
+        writeEnabled_ = false;
+        ++stats_.writeCycles;
+
+        if (powerLossArmed_)
+        {
+            --cyclesBeforeLoss_;
+        }
+    }
+
+    writeAccepted_ = false;
+}
+
+void EEPROM25LC040ASimulator::write_mosi(bool bit)
+{
+    mosi_ = bit;
+}
+
+bool EEPROM25LC040ASimulator::read_miso()
+{
+    return miso_;
+}
+
+void EEPROM25LC040ASimulator::pulse_clock()
+{
+    nowNs_ += clockPeriodNs_;
+    if (!selected_)
+    {
+        return;
+    }
+    ++stats_.clocks;
+
+    // MSB-first: выдаём бит на MISO и одновременно принимаем MOSI
+    miso_ = ((shiftOut_ >> (7 - bitIndex_)) & 0x01u) != 0;
+    shiftIn_ = static_cast<uint8_t>((shiftIn_ << 1) | (mosi_ ? 1u : 0u));
+
+    if (++bitIndex_ == 8)
+    {
+        bitIndex_ = 0;
+        onByte(shiftIn_);
+        ++byteIndex_;
+    }
+}
+
+void EEPROM25LC040ASimulator::delay_us(unsigned us)
+{
+    nowNs_ += static_cast<uint64_t>(us) * 1000;
+    stats_.delayUs += us;
+}
+
+void EEPROM25LC040ASimulator::cutPowerAfter(uint64_t writeCycles, std::size_t tornBytes)
+{
+    powerLossArmed_ = true;
+    cyclesBeforeLoss_ = writeCycles;
+    tornBytes_ = tornBytes;
+}
+
+void EEPROM25LC040ASimulator::restorePower()
+{
+    powerLossArmed_ = false;
+    poweredOff_ = false;
+}
+
+void EEPROM25LC040ASimulator::onByte(uint8_t byte)
+{
+    if (byteIndex_ == 0)
+    {
+        opcode_ = byte;
+        shiftOut_ = 0xFF;
+
+        if (opcode_ == OP_WREN && !busy())
+        {
+            writeEnabled_ = true;
+        }
+        else if (opcode_ == OP_RDSR)
+        {
+            ++stats_.statusPolls;
+            shiftOut_ = static_cast<uint8_t>((busy() ? STATUS_WIP : 0) |
+                                             (writeEnabled_ ? STATUS_WEL : 0));
+        }
+        return;
+    }
+
+    if (opcode_ == OP_RDSR)
+    {
+        // Повторное чтение статуса в том же кадре
+        shiftOut_ = static_cast<uint8_t>((busy() ? STATUS_WIP : 0) |
+                                         (writeEnabled_ ? STATUS_WEL : 0));
+        return;
+    }
+
+    if (opcode_ != OP_READ && opcode_ != OP_WRITE)
+    {
+        return;
+    }
+
+    if (byteIndex_ == 1)
+    {
+        address_ = static_cast<std::size_t>(byte & 0x01u) << 8;
+        return;
+    }
+
+    if (byteIndex_ == 2)
+    {
+        address_ |= byte;
+
+        if (opcode_ == OP_READ && !busy())
+        {
+            shiftOut_ = memory_[address_];
+        }
+        else if (opcode_ == OP_WRITE && writeEnabled_ && !busy() && !poweredOff_)
+        {
+            writeAccepted_ = true;
+            std::memset(pageMask_, 0, sizeof(pageMask_));
+        }
+        return;
+    }
+
+    if (opcode_ == OP_READ)
+    {
+        // Последовательное чтение с переходом через конец памяти
+        address_ = (address_ + 1) % EEPROM25LC040A::CAPACITY_BYTES;
+        shiftOut_ = busy() ? 0xFF : memory_[address_];
+        return;
+    }
+
+    if (writeAccepted_)
+    {
+        // Внутри страницы адрес переходит на её начало
+        const std::size_t offset = (address_ + (byteIndex_ - 3)) % PAGE;
+        page_[offset] = byte;
+        pageMask_[offset] = true;
+    }
+}
+
+EEPROM25LC040ASharedBus::EEPROM25LC040ASharedBus(EEPROM25LC040ASimulator *const *chips,
+                                                 std::size_t count)
+    : chips_{},
+      ports_{},
+      count_(0)
+{
+    for (; chips != nullptr && count_ < count && count_ < MAX_CHIPS; ++count_)
+    {
+        chips_[count_] = chips[count_];
+        ports_[count_].attach(this, chips[count_]);
+    }
+}
+
+void EEPROM25LC040ASharedBus::Port::attach(EEPROM25LC040ASharedBus *bus,
+                                           EEPROM25LC040ASimulator *chip)
+{
+    bus_ = bus;
+    chip_ = chip;
+}
+
+void EEPROM25LC040ASharedBus::Port::cs_low()
+{
+    chip_->cs_low();
+}
+
+void EEPROM25LC040ASharedBus::Port::cs_high()
+{
+    chip_->cs_high();
+}
+
+void EEPROM25LC040ASharedBus::Port::write_mosi(bool bit)
+{
+    for (std::size_t i = 0; i < bus_->count_; ++i)
+    {
+        bus_->chips_[i]->write_mosi(bit);
+    }
+}
+
+bool EEPROM25LC040ASharedBus::Port::read_miso()
+{
+    return chip_->read_miso();
+}
+
+void EEPROM25LC040ASharedBus::Port::pulse_clock()
+{
+    for (std::size_t i = 0; i < bus_->count_; ++i)
+    {
+        bus_->chips_[i]->pulse_clock();
+    }
+}
+
+void EEPROM25LC040ASharedBus::Port::delay_us(unsigned us)
+{
+    for (std::size_t i = 0; i < bus_->count_; ++i)
+    {
+        bus_->chips_[i]->delay_us(us);
+    }
+}
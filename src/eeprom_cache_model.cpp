@@ -0,0 +1,326 @@
+#include "eeprom_cache_model.hpp"
+#include <algorithm>
+
+namespace
+{
+    // Команда и два байта адреса в каждом кадре READ / WRITE
+    constexpr std::size_t FRAME_HEADER = 3;
+}
+
+EEPROMCacheModel::EEPROMCacheModel(const EEPROMCacheConfig &config)
+    : config_(config),
+      report_{},
+      pages_{},
+      useCounter_(0),
+      lastFlushUs_(0),
+      busNs_(0),
+      foregroundNs_(0)
+{
+}
+
+/**
+ * @brief Прогнать трассу и вернуть отчёт.
+ */
+EEPROMCacheReport EEPROMCacheModel::run(EEPROMTraceReader &reader)
+{
+    reset();
+
+    EEPROMTraceRecord record{};
+    while (reader.next(record))
+    {
+        // Периодический сброс выполняется в фоне, вне вызовов API
+        if (config_.policy != EEPROMCacheConfig::Policy::NONE &&
+            config_.flushIntervalUs != 0 &&
+            record.timestampUs - lastFlushUs_ >= config_.flushIntervalUs)
+        {
+            flushAll(false);
+            lastFlushUs_ = record.timestampUs;
+        }
+
+        apply(record);
+        ++report_.operations;
+    }
+
+    flushAll(false);
+
+    report_.busTimeUs = busNs_ / 1000;
+    report_.foregroundUs = foregroundNs_ / 1000;
+    return report_;
+}
+
+void EEPROMCacheModel::reset()
+{
+    report_ = EEPROMCacheReport{};
+    useCounter_ = 0;
+    lastFlushUs_ = 0;
+    busNs_ = 0;
+    foregroundNs_ = 0;
+
+    for (PageState &page : pages_)
+    {
+        page = PageState{};
+    }
+
+    if (config_.policy == EEPROMCacheConfig::Policy::FULL_MIRROR)
+    {
+        // Загрузка зеркала при старте - один кадр на всю микросхему
+        chargeRead(EEPROM25LC040A::CAPACITY_BYTES, false);
+        report_.cacheMisses += PAGE_COUNT;
+        for (PageState &page : pages_)
+        {
+            page.present = true;
+            page.valid = true;
+        }
+    }
+}
+
+void EEPROMCacheModel::apply(const EEPROMTraceRecord &record)
+{
+    const EEPROMOperationInfo &info = record.info;
+
+    // Битовые операции затрагивают покрывающие байты
+    const bool bits = info.op == EEPROMOperation::READ_BITS ||
+                      info.op == EEPROMOperation::WRITE_BITS;
+    std::size_t length = bits ? (info.bitOffset + info.length + 7) / 8 : info.length;
+    if (info.address >= EEPROM25LC040A::CAPACITY_BYTES || length == 0)
+    {
+        return;
+    }
+    length = std::min(length, EEPROM25LC040A::CAPACITY_BYTES - info.address);
+
+    const bool is_write = info.op == EEPROMOperation::WRITE_BYTE ||
+                          info.op == EEPROMOperation::WRITE_ARRAY ||
+                          info.op == EEPROMOperation::WRITE_BITS ||
+                          info.op == EEPROMOperation::WRITE_FIELDS;
+
+    // Частичная запись битов и полей требует чтения исходных байтов
+    const bool read_modify_write = info.op == EEPROMOperation::WRITE_BITS ||
+                                   info.op == EEPROMOperation::WRITE_FIELDS;
+
+    if (config_.policy == EEPROMCacheConfig::Policy::NONE)
+    {
+        if (bits)
+        {
+            // readBits / writeBits работают побайтно
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                directRead(info.address + i, 1);
+                if (is_write)
+                {
+                    directWrite(info.address + i, 1);
+                }
+            }
+            return;
+        }
+
+        if (read_modify_write || !is_write)
+        {
+            directRead(info.address, length);
+        }
+        if (is_write)
+        {
+            directWrite(info.address, length);
+        }
+        return;
+    }
+
+    if (read_modify_write || !is_write)
+    {
+        cachedRead(info.address, length);
+    }
+    if (is_write)
+    {
+        cachedWrite(info.address, length);
+    }
+}
+
+void EEPROMCacheModel::charge(uint64_t ns, bool foreground)
+{
+    busNs_ += ns;
+    if (foreground)
+    {
+        foregroundNs_ += ns;
+    }
+}
+
+void EEPROMCacheModel::chargeRead(std::size_t length, bool foreground)
+{
+    ++report_.busTransactions;
+    report_.busBytes += FRAME_HEADER + length;
+    charge(static_cast<uint64_t>(FRAME_HEADER + length) * 8 * config_.clockPeriodNs, foreground);
+}
+
+void EEPROMCacheModel::chargeWrite(std::size_t length, bool foreground)
+{
+    // Кадр WREN, кадр WRITE и ожидание tWC
+    ++report_.busTransactions;
+    ++report_.writeCycles;
+    report_.busBytes += 1 + FRAME_HEADER + length;
+    charge(static_cast<uint64_t>(1 + FRAME_HEADER + length) * 8 * config_.clockPeriodNs +
+               static_cast<uint64_t>(config_.writeCycleUs) * 1000,
+           foreground);
+}
+
+void EEPROMCacheModel::directRead(std::size_t, std::size_t length)
+{
+    chargeRead(length, true);
+}
+
+void EEPROMCacheModel::directWrite(std::size_t address, std::size_t length)
+{
+    // writeArray делит запись по границам страниц
+    while (length > 0)
+    {
+        const std::size_t chunk = std::min(length, PAGE - address % PAGE);
+        chargeWrite(chunk, true);
+        address += chunk;
+        length -= chunk;
+    }
+}
+
+void EEPROMCacheModel::cachedRead(std::size_t address, std::size_t length)
+{
+    const std::size_t first = address / PAGE;
+    const std::size_t last = (address + length - 1) / PAGE;
+
+    std::size_t page = first;
+    while (page <= last)
+    {
+        if (pages_[page].present && pages_[page].valid)
+        {
+            ++report_.cacheHits;
+            touch(page);
+            ++page;
+            continue;
+        }
+
+        // Непрерывный участок промахов плюс упреждающее чтение - одним кадром
+        std::size_t run_end = page;
+        while (run_end <= last && !(pages_[run_end].present && pages_[run_end].valid))
+        {
+            ++run_end;
+        }
+        std::size_t ahead = 0;
+        while (ahead < config_.readaheadPages && run_end < PAGE_COUNT &&
+               !(pages_[run_end].present && pages_[run_end].valid))
+        {
+            ++run_end;
+            ++ahead;
+        }
+
+        if (config_.policy == EEPROMCacheConfig::Policy::LRU)
+        {
+            run_end = std::min(run_end, page + std::max<std::size_t>(config_.lruPages, 1));
+        }
+
+        chargeRead((run_end - page) * PAGE, true);
+        for (std::size_t p = page; p < run_end; ++p)
+        {
+            ++report_.cacheMisses;
+            makeRoom(p);
+            pages_[p].present = true;
+            pages_[p].valid = true;
+            touch(p);
+        }
+
+        page = run_end;
+    }
+}
+
+void EEPROMCacheModel::cachedWrite(std::size_t address, std::size_t length)
+{
+    const std::size_t end = address + length;
+
+    while (address < end)
+    {
+        const std::size_t page = address / PAGE;
+        const std::size_t chunk_end = std::min(end, (page + 1) * PAGE);
+
+        makeRoom(page);
+        PageState &state = pages_[page];
+        state.present = true;
+
+        const std::size_t from = address % PAGE;
+        const std::size_t to = (chunk_end - 1) % PAGE;
+        state.dirtyFrom = state.dirty ? std::min(state.dirtyFrom, from) : from;
+        state.dirtyTo = state.dirty ? std::max(state.dirtyTo, to) : to;
+        state.dirtyMask |= static_cast<uint32_t>((uint64_t{1} << (to + 1)) - (uint64_t{1} << from));
+        state.dirty = true;
+        touch(page);
+
+        if (config_.flushIntervalUs == 0)
+        {
+            flushPage(page, true); // Сквозная запись
+        }
+
+        address = chunk_end;
+    }
+}
+
+void EEPROMCacheModel::touch(std::size_t page)
+{
+    pages_[page].lastUse = ++useCounter_;
+}
+
+void EEPROMCacheModel::makeRoom(std::size_t page)
+{
+    if (config_.policy != EEPROMCacheConfig::Policy::LRU || pages_[page].present)
+    {
+        return;
+    }
+
+    std::size_t present = 0;
+    std::size_t victim = PAGE_COUNT;
+    for (std::size_t p = 0; p < PAGE_COUNT; ++p)
+    {
+        if (!pages_[p].present)
+        {
+            continue;
+        }
+        ++present;
+        if (victim == PAGE_COUNT || pages_[p].lastUse < pages_[victim].lastUse)
+        {
+            victim = p;
+        }
+    }
+
+    if (present < std::max<std::size_t>(config_.lruPages, 1))
+    {
+        return;
+    }
+
+    // Вытеснение изменённой страницы - запись внутри текущего вызова
+    flushPage(victim, true);
+    pages_[victim] = PageState{};
+}
+
+void EEPROMCacheModel::flushPage(std::size_t page, bool foreground)
+{
+    PageState &state = pages_[page];
+    if (!state.dirty)
+    {
+        return;
+    }
+
+    // Промежутки в изменённом участке нечем заполнить без чтения страницы
+    const uint32_t span = static_cast<uint32_t>((uint64_t{1} << (state.dirtyTo + 1)) -
+                                                (uint64_t{1} << state.dirtyFrom));
+    if (!state.valid && (state.dirtyMask & span) != span)
+    {
+        ++report_.cacheMisses;
+        chargeRead(PAGE, foreground);
+        state.valid = true;
+    }
+
+    chargeWrite(state.dirtyTo - state.dirtyFrom + 1, foreground);
+    state.dirty = false;
+    state.dirtyMask = 0;
+}
+
+void EEPROMCacheModel::flushAll(bool foreground)
+{
+    for (std::size_t page = 0; page < PAGE_COUNT; ++page)
+    {
+        flushPage(page, foreground);
+    }
+}
@@ -0,0 +1,277 @@
+#include "eeprom_compression.hpp"
+#include "eeprom_checksum.hpp"
+
+namespace
+{
+    // Метод хранения записи
+    constexpr uint8_t METHOD_STORED = 0;
+    constexpr uint8_t METHOD_LZSS = 1;
+
+    // Размер кадра чтения при декодировании
+    constexpr std::size_t READ_CHUNK = EEPROM25LC040A::CANCEL_CHUNK;
+
+    /**
+     * @brief Найти самое длинное совпадение в окне перед position.
+     */
+    std::size_t longestMatch(const uint8_t *input,
+                             std::size_t length,
+                             std::size_t position,
+                             std::size_t &offset)
+    {
+        const std::size_t window_start = (position > LZ_WINDOW) ? position - LZ_WINDOW : 0;
+        const std::size_t max_length = (length - position < LZ_MAX_MATCH)
+                                           ? length - position
+                                           : LZ_MAX_MATCH;
+
+        std::size_t best = 0;
+        for (std::size_t candidate = window_start; candidate < position; ++candidate)
+        {
+            // Совпадение может заходить за position (повтор последовательности)
+            std::size_t matched = 0;
+            while (matched < max_length && input[candidate + matched] == input[position + matched])
+            {
+                ++matched;
+            }
+
+            // При равной длине выбираем ближнее - перебор идёт к position
+            if (matched >= best && matched > 0)
+            {
+                best = matched;
+                offset = position - candidate;
+            }
+        }
+
+        return best;
+    }
+}
+
+/**
+ * @brief Сжать данные.
+ */
+std::size_t lzCompress(const uint8_t *input,
+                       std::size_t length,
+                       uint8_t *output,
+                       std::size_t capacity)
+{
+    if (input == nullptr || output == nullptr)
+    {
+        return 0;
+    }
+
+    std::size_t out = 0;
+    std::size_t flags_at = 0;
+    unsigned items = 8;
+
+    std::size_t position = 0;
+    while (position < length)
+    {
+        // Новый управляющий байт на каждые 8 элементов
+        if (items == 8)
+        {
+            if (out >= capacity)
+            {
+                return 0;
+            }
+            flags_at = out;
+            output[out++] = 0;
+            items = 0;
+        }
+
+        std::size_t offset = 0;
+        const std::size_t matched = longestMatch(input, length, position, offset);
+
+        if (matched >= LZ_MIN_MATCH)
+        {
+            if (out + 2 > capacity)
+            {
+                return 0;
+            }
+            output[out++] = static_cast<uint8_t>(offset - 1);
+            output[out++] = static_cast<uint8_t>(matched - LZ_MIN_MATCH);
+            position += matched;
+        }
+        else
+        {
+            if (out >= capacity)
+            {
+                return 0;
+            }
+            output[flags_at] = static_cast<uint8_t>(output[flags_at] | (1u << items));
+            output[out++] = input[position++];
+        }
+
+        ++items;
+    }
+
+    return out;
+}
+
+LzDecoder::LzDecoder(uint8_t *output, std::size_t capacity)
+    : output_(output),
+      capacity_(output != nullptr ? capacity : 0),
+      size_(0),
+      flags_(0),
+      flagsLeft_(0),
+      offset_(0),
+      failed_(false)
+{
+}
+
+/**
+ * @brief Передать очередную часть сжатого потока.
+ */
+bool LzDecoder::feed(const uint8_t *data, std::size_t length)
+{
+    for (std::size_t i = 0; i < length && !failed_ && size_ < capacity_; ++i)
+    {
+        const uint8_t byte = data[i];
+
+        if (flagsLeft_ == 0)
+        {
+            flags_ = byte;
+            flagsLeft_ = 8;
+            continue;
+        }
+
+        if (flags_ & 1u)
+        {
+            // Литерал
+            output_[size_++] = byte;
+        }
+        else if (offset_ == 0)
+        {
+            // Первый байт ссылки - смещение
+            offset_ = static_cast<std::size_t>(byte) + 1;
+            continue;
+        }
+        else
+        {
+            // Второй байт ссылки - длина
+            const std::size_t count = static_cast<std::size_t>(byte) + LZ_MIN_MATCH;
+            if (offset_ > size_ || count > capacity_ - size_)
+            {
+                failed_ = true;
+                break;
+            }
+
+            // Побайтно: источник может перекрываться с результатом
+            for (std::size_t k = 0; k < count; ++k, ++size_)
+            {
+                output_[size_] = output_[size_ - offset_];
+            }
+            offset_ = 0;
+        }
+
+        flags_ = static_cast<uint8_t>(flags_ >> 1);
+        --flagsLeft_;
+    }
+
+    return !failed_;
+}
+
+/**
+ * @brief Записать запись в EEPROM, по возможности сжав её.
+ */
+std::size_t writeCompressedRecord(EEPROM25LC040A &eeprom,
+                                  std::size_t address,
+                                  const uint8_t *data,
+                                  std::size_t length,
+                                  std::size_t capacity)
+{
+    if (data == nullptr || length > EEPROM25LC040A::CAPACITY_BYTES ||
+        capacity < LZ_RECORD_HEADER)
+    {
+        return 0;
+    }
+
+    // Заголовок и данные передаются одной записью writeArray
+    uint8_t record[LZ_RECORD_HEADER + EEPROM25LC040A::CAPACITY_BYTES];
+
+    // Сжатый вариант берём, только если он меньше исходного
+    const std::size_t limit = (length > 0) ? length - 1 : 0;
+    std::size_t stored = lzCompress(data, length, record + LZ_RECORD_HEADER, limit);
+    uint8_t method = METHOD_LZSS;
+    if (stored == 0)
+    {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            record[LZ_RECORD_HEADER + i] = data[i];
+        }
+        stored = length;
+        method = METHOD_STORED;
+    }
+
+    if (LZ_RECORD_HEADER + stored > capacity)
+    {
+        return 0;
+    }
+
+    record[0] = method;
+    record[1] = static_cast<uint8_t>(length & 0xFF);
+    record[2] = static_cast<uint8_t>(length >> 8);
+    record[3] = static_cast<uint8_t>(stored & 0xFF);
+    record[4] = static_cast<uint8_t>(stored >> 8);
+    record[5] = crc8(record, LZ_RECORD_HEADER - 1);
+
+    eeprom.writeArray(address, record, LZ_RECORD_HEADER + stored);
+    return LZ_RECORD_HEADER + stored;
+}
+
+/**
+ * @brief Прочитать запись, сохранённую writeCompressedRecord().
+ */
+std::size_t readCompressedRecord(const EEPROM25LC040A &eeprom,
+                                 std::size_t address,
+                                 uint8_t *data,
+                                 std::size_t capacity)
+{
+    if (data == nullptr)
+    {
+        return 0;
+    }
+
+    uint8_t header[LZ_RECORD_HEADER];
+    eeprom.readArray(address, header, LZ_RECORD_HEADER);
+    if (crc8(header, LZ_RECORD_HEADER - 1) != header[5])
+    {
+        return 0;
+    }
+
+    const std::size_t length = header[1] | (static_cast<std::size_t>(header[2]) << 8);
+    const std::size_t stored = header[3] | (static_cast<std::size_t>(header[4]) << 8);
+    if (length > capacity || address + LZ_RECORD_HEADER + stored > EEPROM25LC040A::CAPACITY_BYTES)
+    {
+        return 0;
+    }
+
+    if (header[0] == METHOD_STORED)
+    {
+        if (stored != length)
+        {
+            return 0;
+        }
+        eeprom.readArray(address + LZ_RECORD_HEADER, data, length);
+        return length;
+    }
+
+    if (header[0] != METHOD_LZSS)
+    {
+        return 0;
+    }
+
+    LzDecoder decoder(data, length);
+    uint8_t chunk_data[READ_CHUNK];
+    std::size_t offset = 0;
+    while (offset < stored && !decoder.done())
+    {
+        const std::size_t chunk = (stored - offset < READ_CHUNK) ? stored - offset : READ_CHUNK;
+        eeprom.readArray(address + LZ_RECORD_HEADER + offset, chunk_data, chunk);
+        if (!decoder.feed(chunk_data, chunk))
+        {
+            return 0;
+        }
+        offset += chunk;
+    }
+
+    return decoder.done() ? length : 0;
+}
@@ -0,0 +1,425 @@
+#include "eeprom_layout_migration.hpp"
+#include "eeprom_checksum.hpp"
+#include <cstring>
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+
+    // Журнал: [0], [1] - страницы слотов заголовка, [2] - данные шага, [3] - буфер цикла.
+    // Формат слота: [0] MAGIC, [1] generation, [2] step, [3] page,
+    // [4..7] planCrc, [8..11] dataCrc, [12..14] 0, [15] CRC-8 байтов 0..14
+    constexpr std::size_t SLOT_SIZE = PAGE;
+    constexpr std::size_t SLOT_COUNT = 2;
+    constexpr std::size_t DATA_PAGE = 2;
+    constexpr std::size_t STASH_PAGE = 3;
+    constexpr uint8_t SLOT_MAGIC = 0xA5;
+    constexpr uint8_t STEP_DONE = 0xFF;
+
+    static_assert(EEPROMLayoutMigration::MAX_STEPS < STEP_DONE, "номер шага должен помещаться в байт");
+
+    uint32_t pageCrc(const uint8_t *data)
+    {
+        return crc32(data, PAGE);
+    }
+
+    void putU32(uint8_t *out, uint32_t value)
+    {
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            out[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    uint32_t getU32(const uint8_t *in)
+    {
+        return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 |
+               static_cast<uint32_t>(in[2]) << 16 | static_cast<uint32_t>(in[3]) << 24;
+    }
+
+    bool overlaps(std::size_t a, std::size_t a_len, std::size_t b, std::size_t b_len)
+    {
+        return a < b + b_len && b < a + a_len;
+    }
+}
+
+EEPROMLayoutMigration::EEPROMLayoutMigration(EEPROM25LC040A &eeprom,
+                                             const FieldPlacement *oldLayout,
+                                             std::size_t oldCount,
+                                             const FieldPlacement *newLayout,
+                                             std::size_t newCount,
+                                             std::size_t journalAddress)
+    : eeprom_(eeprom),
+      oldLayout_(oldLayout),
+      oldCount_(oldCount),
+      newLayout_(newLayout),
+      newCount_(newCount),
+      journalAddress_(journalAddress),
+      planned_(false),
+      stepCount_(0),
+      order_{},
+      kinds_{}
+{
+}
+
+/**
+ * @brief Вычислить набор и порядок перезаписываемых страниц.
+ */
+bool EEPROMLayoutMigration::plan()
+{
+    planned_ = false;
+    stepCount_ = 0;
+
+    constexpr std::size_t capacity = EEPROM25LC040A::CAPACITY_BYTES;
+    if (journalAddress_ % PAGE != 0 || journalAddress_ + JOURNAL_SIZE > capacity)
+    {
+        return false;
+    }
+
+    // Поля обеих раскладок должны лежать в микросхеме и не задевать журнал
+    const FieldPlacement *layouts[] = {oldLayout_, newLayout_};
+    const std::size_t counts[] = {oldCount_, newCount_};
+    for (std::size_t l = 0; l < 2; ++l)
+    {
+        for (std::size_t i = 0; i < counts[l]; ++i)
+        {
+            const FieldPlacement &field = layouts[l][i];
+            if (field.address + field.size > capacity ||
+                overlaps(field.address, field.size, journalAddress_, JOURNAL_SIZE))
+            {
+                return false;
+            }
+        }
+    }
+
+    // rewrite - страницы, которые меняются; sources[P] - чьё старое содержимое читает P
+    uint32_t rewrite = 0;
+    uint32_t sources[PAGE_COUNT] = {};
+
+    for (std::size_t i = 0; i < newCount_; ++i)
+    {
+        const FieldPlacement &field = newLayout_[i];
+        const FieldPlacement *old = findOldField(field.id);
+
+        for (std::size_t offset = 0; offset < field.size; ++offset)
+        {
+            const std::size_t page = (field.address + offset) / PAGE;
+            const bool has_source = old != nullptr && offset < old->size;
+
+            if (has_source && old->address == field.address)
+            {
+                continue; // Байт остаётся на месте
+            }
+
+            rewrite |= 1u << page;
+            if (has_source)
+            {
+                const std::size_t source_page = (old->address + offset) / PAGE;
+                if (source_page != page)
+                {
+                    sources[page] |= 1u << source_page;
+                }
+            }
+        }
+    }
+
+    // Топологическая сортировка: страница пишется, когда все страницы,
+    // читающие её старое содержимое, уже переписаны
+    uint32_t pending = rewrite;
+    std::size_t staged = PAGE_COUNT; // Страница, новое содержимое которой в буфере
+    while (pending != 0)
+    {
+        // Страница из буфера переносится первой, чтобы освободить буфер
+        std::size_t next = PAGE_COUNT;
+        if (staged != PAGE_COUNT && isReady(staged, pending, staged, sources))
+        {
+            next = staged;
+        }
+        for (std::size_t page = 0; page < PAGE_COUNT && next == PAGE_COUNT; ++page)
+        {
+            if ((pending & (1u << page)) != 0 && isReady(page, pending, staged, sources))
+            {
+                next = page;
+            }
+        }
+
+        if (next != PAGE_COUNT)
+        {
+            addStep(next == staged ? StepKind::COMMIT : StepKind::WRITE, next);
+            pending &= ~(1u << next);
+            staged = next == staged ? PAGE_COUNT : staged;
+            continue;
+        }
+
+        // Цикл: в буфер сохраняется страница, после которой какая-то страница
+        // становится готовой - её источники ещё целы, и она их больше не читает
+        if (staged != PAGE_COUNT)
+        {
+            stepCount_ = 0;
+            return false; // Буфер уже занят другой страницей цикла
+        }
+
+        for (std::size_t page = 0; page < PAGE_COUNT && staged == PAGE_COUNT; ++page)
+        {
+            if ((pending & (1u << page)) == 0)
+            {
+                continue;
+            }
+
+            for (std::size_t other = 0; other < PAGE_COUNT; ++other)
+            {
+                if (other != page && (pending & (1u << other)) != 0 &&
+                    isReady(other, pending, page, sources))
+                {
+                    staged = page;
+                    break;
+                }
+            }
+        }
+
+        if (staged == PAGE_COUNT)
+        {
+            stepCount_ = 0;
+            return false;
+        }
+
+        addStep(StepKind::STAGE, staged);
+    }
+
+    planned_ = true;
+    return true;
+}
+
+/**
+ * @brief Выполнить (или продолжить прерванную) миграцию.
+ */
+bool EEPROMLayoutMigration::run()
+{
+    if (!planned_ && !plan())
+    {
+        return false;
+    }
+
+    // Текущий образ микросхемы одним кадром
+    uint8_t image[EEPROM25LC040A::CAPACITY_BYTES];
+    eeprom_.readArray(0, image, sizeof(image));
+
+    const std::size_t data_address = journalAddress_ + DATA_PAGE * PAGE;
+    const std::size_t stash_address = journalAddress_ + STASH_PAGE * PAGE;
+
+    JournalSlot latest{};
+    std::size_t latest_index = SLOT_COUNT - 1;
+    const bool has_journal = readLatestSlot(image + journalAddress_, latest, latest_index);
+
+    uint8_t generation = has_journal ? latest.generation : 0;
+    std::size_t slot_index = (latest_index + 1) % SLOT_COUNT;
+    std::size_t first_step = 0;
+    bool written = false;
+
+    const uint32_t tag = planTag();
+    if (has_journal && latest.step == STEP_DONE && latest.planCrc == tag)
+    {
+        return true; // Эта миграция уже завершена
+    }
+
+    if (has_journal && latest.step != STEP_DONE)
+    {
+        // Прерванная миграция должна совпадать с текущим планом
+        if (latest.planCrc != tag || latest.step >= stepCount_ || order_[latest.step] != latest.page)
+        {
+            return false;
+        }
+
+        // Если данные шага целы, шаг мог не завершиться - повторяем запись
+        // страницы на место. Иначе их уже заняли данные следующего шага,
+        // а он начинается только после записи этой страницы.
+        const StepKind kind = kinds_[latest.step];
+        const uint8_t *data = image + (kind == StepKind::WRITE ? data_address : stash_address);
+        if (kind != StepKind::STAGE && pageCrc(data) == latest.dataCrc)
+        {
+            eeprom_.writeArray(latest.page * PAGE, data, PAGE);
+            std::memcpy(image + latest.page * PAGE, data, PAGE);
+        }
+
+        first_step = latest.step + 1u;
+        written = true;
+    }
+
+    for (std::size_t step = first_step; step < stepCount_; ++step)
+    {
+        const std::size_t page = order_[step];
+        const StepKind kind = kinds_[step];
+
+        uint8_t content[PAGE];
+        if (kind == StepKind::COMMIT)
+        {
+            std::memcpy(content, image + stash_address, PAGE);
+        }
+        else
+        {
+            buildPage(page, image, content);
+        }
+
+        if (kind != StepKind::STAGE && std::memcmp(content, image + page * PAGE, PAGE) == 0)
+        {
+            continue;
+        }
+
+        // 1. Данные в журнал (кроме переноса из буфера), 2. заголовок шага,
+        // 3. страница на место (кроме сохранения в буфер)
+        if (kind != StepKind::COMMIT)
+        {
+            const std::size_t address = kind == StepKind::WRITE ? data_address : stash_address;
+            eeprom_.writeArray(address, content, PAGE);
+            std::memcpy(image + address, content, PAGE);
+        }
+
+        writeSlot(slot_index, JournalSlot{++generation,
+                                          static_cast<uint8_t>(step),
+                                          static_cast<uint8_t>(page),
+                                          tag,
+                                          pageCrc(content)});
+        slot_index = (slot_index + 1) % SLOT_COUNT;
+
+        if (kind != StepKind::STAGE)
+        {
+            eeprom_.writeArray(page * PAGE, content, PAGE);
+            std::memcpy(image + page * PAGE, content, PAGE);
+        }
+        written = true;
+    }
+
+    if (written)
+    {
+        writeSlot(slot_index, JournalSlot{++generation, STEP_DONE, 0, tag, 0});
+    }
+
+    return true;
+}
+
+bool EEPROMLayoutMigration::readLatestSlot(const uint8_t *header,
+                                           JournalSlot &slot,
+                                           std::size_t &index)
+{
+    bool found = false;
+
+    for (std::size_t i = 0; i < SLOT_COUNT; ++i)
+    {
+        const uint8_t *raw = header + i * SLOT_SIZE;
+        if (raw[0] != SLOT_MAGIC || raw[SLOT_SIZE - 1] != crc8(raw, SLOT_SIZE - 1))
+        {
+            continue; // Слот пуст или запись прервана
+        }
+
+        const JournalSlot candidate{raw[1], raw[2], raw[3], getU32(raw + 4), getU32(raw + 8)};
+
+        // Более свежий слот - с большим номером записи (по модулю 256)
+        if (!found || static_cast<uint8_t>(candidate.generation - slot.generation) < 0x80)
+        {
+            slot = candidate;
+            index = i;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+void EEPROMLayoutMigration::writeSlot(std::size_t index, const JournalSlot &slot)
+{
+    uint8_t raw[SLOT_SIZE] = {SLOT_MAGIC, slot.generation, slot.step, slot.page};
+    putU32(raw + 4, slot.planCrc);
+    putU32(raw + 8, slot.dataCrc);
+    raw[SLOT_SIZE - 1] = crc8(raw, SLOT_SIZE - 1);
+
+    // Слот занимает свою страницу - второй слот при сбое остаётся целым
+    eeprom_.writeArray(journalAddress_ + index * SLOT_SIZE, raw, SLOT_SIZE);
+}
+
+uint32_t EEPROMLayoutMigration::planTag() const
+{
+    uint32_t tag = 0;
+    const FieldPlacement *layouts[] = {oldLayout_, newLayout_};
+    const std::size_t counts[] = {oldCount_, newCount_};
+
+    for (std::size_t l = 0; l < 2; ++l)
+    {
+        for (std::size_t i = 0; i < counts[l]; ++i)
+        {
+            const FieldPlacement &field = layouts[l][i];
+            const uint8_t raw[] = {static_cast<uint8_t>(l),
+                                   static_cast<uint8_t>(field.id),
+                                   static_cast<uint8_t>(field.id >> 8),
+                                   static_cast<uint8_t>(field.address),
+                                   static_cast<uint8_t>(field.address >> 8),
+                                   static_cast<uint8_t>(field.size),
+                                   static_cast<uint8_t>(field.size >> 8)};
+            tag = crc32(raw, sizeof(raw), tag);
+        }
+    }
+
+    return tag;
+}
+
+bool EEPROMLayoutMigration::isReady(std::size_t page, uint32_t pending, std::size_t staged,
+                                    const uint32_t *sources)
+{
+    for (std::size_t reader = 0; reader < PAGE_COUNT; ++reader)
+    {
+        if (reader != page && reader != staged && (pending & (1u << reader)) != 0 &&
+            (sources[reader] & (1u << page)) != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void EEPROMLayoutMigration::addStep(StepKind kind, std::size_t page)
+{
+    order_[stepCount_] = static_cast<uint8_t>(page);
+    kinds_[stepCount_] = kind;
+    ++stepCount_;
+}
+
+const FieldPlacement *EEPROMLayoutMigration::findOldField(uint16_t id) const
+{
+    for (std::size_t i = 0; i < oldCount_; ++i)
+    {
+        if (oldLayout_[i].id == id)
+        {
+            return &oldLayout_[i];
+        }
+    }
+    return nullptr;
+}
+
+void EEPROMLayoutMigration::buildPage(std::size_t page, const uint8_t *image, uint8_t *out) const
+{
+    const std::size_t base = page * PAGE;
+    std::memcpy(out, image + base, PAGE);
+
+    for (std::size_t i = 0; i < newCount_; ++i)
+    {
+        const FieldPlacement &field = newLayout_[i];
+        if (!overlaps(field.address, field.size, base, PAGE))
+        {
+            continue;
+        }
+
+        const FieldPlacement *old = findOldField(field.id);
+        for (std::size_t address = field.address; address < field.address + field.size; ++address)
+        {
+            if (address < base || address >= base + PAGE)
+            {
+                continue;
+            }
+
+            const std::size_t offset = address - field.address;
+            out[address - base] = (old != nullptr && offset < old->size)
+                                      ? image[old->address + offset]
+                                      : 0xFF;
+        }
+    }
+}
@@ -0,0 +1,282 @@
+#include "eeprom_layout_optimizer.hpp"
+#include "eeprom_25lc040a.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+
+    /**
+     * @brief Найти представителя группы (система непересекающихся множеств).
+     */
+    std::size_t findRoot(std::vector<std::size_t> &parent, std::size_t i)
+    {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+}
+
+FieldLayoutOptimizer::FieldLayoutOptimizer(const FieldPlacement *current,
+                                           std::size_t count,
+                                           std::size_t regionStart,
+                                           std::size_t regionSize)
+    : current_(current, current + count),
+      optimized_(current, current + count),
+      regionStart_(regionStart),
+      regionSize_(regionSize)
+{
+}
+
+/**
+ * @brief Учесть запись из трассы.
+ */
+void FieldLayoutOptimizer::addWrite(std::size_t address, std::size_t length)
+{
+    for (std::size_t i = 0; i < current_.size(); ++i)
+    {
+        const FieldPlacement &field = current_[i];
+        if (address < field.address + field.size && field.address < address + length &&
+            std::find(openBatch_.begin(), openBatch_.end(), i) == openBatch_.end())
+        {
+            openBatch_.push_back(i);
+        }
+    }
+}
+
+/**
+ * @brief Завершить пакет обновлений.
+ */
+void FieldLayoutOptimizer::endBatch()
+{
+    if (!openBatch_.empty())
+    {
+        batches_.push_back(openBatch_);
+        openBatch_.clear();
+    }
+}
+
+/**
+ * @brief Вычислить новую раскладку.
+ */
+bool FieldLayoutOptimizer::optimize()
+{
+    endBatch();
+
+    if (!validLayout(current_) || regionStart_ > CAPACITY || regionSize_ > CAPACITY - regionStart_)
+    {
+        return false;
+    }
+
+    const std::size_t n = current_.size();
+
+    // Число совместных обновлений для каждой пары полей
+    std::vector<std::size_t> weight(n * n, 0);
+    for (const std::vector<std::size_t> &batch : batches_)
+    {
+        for (std::size_t a = 0; a < batch.size(); ++a)
+        {
+            for (std::size_t b = a + 1; b < batch.size(); ++b)
+            {
+                ++weight[batch[a] * n + batch[b]];
+                ++weight[batch[b] * n + batch[a]];
+            }
+        }
+    }
+
+    struct Pair
+    {
+        std::size_t a;
+        std::size_t b;
+        std::size_t weight;
+    };
+
+    std::vector<Pair> pairs;
+    for (std::size_t a = 0; a < n; ++a)
+    {
+        for (std::size_t b = a + 1; b < n; ++b)
+        {
+            if (weight[a * n + b] > 0)
+            {
+                pairs.push_back(Pair{a, b, weight[a * n + b]});
+            }
+        }
+    }
+    std::stable_sort(pairs.begin(), pairs.end(),
+                     [](const Pair &x, const Pair &y)
+                     { return x.weight > y.weight; });
+
+    // Объединяем поля в группы, пока группа помещается в страницу
+    std::vector<std::size_t> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    std::vector<std::size_t> group_size(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        group_size[i] = current_[i].size;
+    }
+
+    for (const Pair &pair : pairs)
+    {
+        const std::size_t ra = findRoot(parent, pair.a);
+        const std::size_t rb = findRoot(parent, pair.b);
+        if (ra != rb && group_size[ra] + group_size[rb] <= PAGE)
+        {
+            parent[rb] = ra;
+            group_size[ra] += group_size[rb];
+        }
+    }
+
+    // Группы в порядке убывания размера
+    std::vector<std::vector<std::size_t>> groups(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        groups[findRoot(parent, i)].push_back(i);
+    }
+
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        if (!groups[i].empty())
+        {
+            order.push_back(i);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t x, std::size_t y)
+                     { return group_size[x] > group_size[y]; });
+
+    // Упаковка в страницы (first-fit decreasing)
+    const std::size_t start = (regionStart_ + PAGE - 1) / PAGE * PAGE;
+    const std::size_t skipped = start - regionStart_;
+    if (skipped > regionSize_)
+    {
+        return false;
+    }
+    const std::size_t max_pages = (regionSize_ - skipped) / PAGE;
+
+    std::vector<std::size_t> used; // Занятые байты каждой открытой страницы
+    std::vector<FieldPlacement> layout = current_;
+
+    for (std::size_t root : order)
+    {
+        const std::size_t size = group_size[root];
+        std::size_t page = used.size();
+
+        if (size <= PAGE)
+        {
+            for (std::size_t p = 0; p < used.size(); ++p)
+            {
+                if (used[p] + size <= PAGE)
+                {
+                    page = p;
+                    break;
+                }
+            }
+            if (page == used.size())
+            {
+                used.push_back(0);
+            }
+        }
+        else
+        {
+            // Крупное поле - с границы новой страницы, остаток последней страницы свободен
+            const std::size_t pages = (size + PAGE - 1) / PAGE;
+            used.insert(used.end(), pages - 1, PAGE);
+            used.push_back(size - (pages - 1) * PAGE);
+            page = used.size() - pages;
+            layout[root].address = start + page * PAGE;
+            continue;
+        }
+
+        std::size_t address = start + page * PAGE + used[page];
+        for (std::size_t field : groups[root])
+        {
+            layout[field].address = address;
+            address += current_[field].size;
+        }
+        used[page] += size;
+    }
+
+    if (used.size() > max_pages)
+    {
+        return false;
+    }
+
+    optimized_ = layout;
+    return true;
+}
+
+/**
+ * @brief Переносы полей, адреса которых изменились.
+ */
+std::vector<FieldMove> FieldLayoutOptimizer::migrationPlan() const
+{
+    std::vector<FieldMove> moves;
+
+    for (std::size_t i = 0; i < current_.size(); ++i)
+    {
+        if (current_[i].address != optimized_[i].address)
+        {
+            moves.push_back(FieldMove{current_[i].id,
+                                      current_[i].address,
+                                      optimized_[i].address,
+                                      current_[i].size});
+        }
+    }
+
+    return moves;
+}
+
+/**
+ * @brief Суммарное число программируемых страниц по всей трассе.
+ */
+std::size_t FieldLayoutOptimizer::pagePrograms(const std::vector<FieldPlacement> &layout) const
+{
+    std::size_t total = 0;
+    std::vector<std::size_t> pages;
+
+    for (const std::vector<std::size_t> &batch : batches_)
+    {
+        pages.clear();
+        for (std::size_t field : batch)
+        {
+            const FieldPlacement &placement = layout[field];
+            if (placement.size == 0)
+            {
+                continue;
+            }
+
+            for (std::size_t p = placement.address / PAGE;
+                 p <= (placement.address + placement.size - 1) / PAGE; ++p)
+            {
+                pages.push_back(p);
+            }
+        }
+
+        std::sort(pages.begin(), pages.end());
+        total += static_cast<std::size_t>(std::unique(pages.begin(), pages.end()) - pages.begin());
+    }
+
+    return total;
+}
+
+/**
+ * @brief Проверить раскладку.
+ */
+bool FieldLayoutOptimizer::validLayout(const std::vector<FieldPlacement> &layout)
+{
+    for (const FieldPlacement &field : layout)
+    {
+        if (field.size == 0 || field.address >= CAPACITY || field.size > CAPACITY - field.address)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
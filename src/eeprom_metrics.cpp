@@ -0,0 +1,307 @@
+#include "eeprom_metrics.hpp"
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+
+    constexpr EEPROMOperation OPERATIONS[] = {
+        EEPROMOperation::READ_BYTE,
+        EEPROMOperation::WRITE_BYTE,
+        EEPROMOperation::READ_ARRAY,
+        EEPROMOperation::WRITE_ARRAY,
+        EEPROMOperation::READ_BITS,
+        EEPROMOperation::WRITE_BITS,
+        EEPROMOperation::READ_FIELDS,
+        EEPROMOperation::WRITE_FIELDS,
+    };
+
+    constexpr double QUANTILES[] = {0.5, 0.9, 0.99};
+
+    /**
+     * @brief Затронутые операцией байты.
+     */
+    std::size_t byteLength(const EEPROMOperationInfo &info)
+    {
+        const bool bits = info.op == EEPROMOperation::READ_BITS ||
+                          info.op == EEPROMOperation::WRITE_BITS;
+        return bits ? (info.bitOffset + info.length + 7) / 8 : info.length;
+    }
+
+    bool isWrite(EEPROMOperation op)
+    {
+        return op == EEPROMOperation::WRITE_BYTE || op == EEPROMOperation::WRITE_ARRAY ||
+               op == EEPROMOperation::WRITE_BITS || op == EEPROMOperation::WRITE_FIELDS;
+    }
+
+    /**
+     * @brief Вывод текста в буфер с отслеживанием переполнения.
+     */
+    class TextWriter
+    {
+    public:
+        TextWriter(char *buffer, std::size_t capacity)
+            : buffer_(buffer), capacity_(capacity), length_(0), overflow_(buffer == nullptr || capacity == 0)
+        {
+        }
+
+        void print(const char *format, ...)
+        {
+            if (overflow_)
+            {
+                return;
+            }
+
+            va_list args;
+            va_start(args, format);
+            const int written = std::vsnprintf(buffer_ + length_, capacity_ - length_, format, args);
+            va_end(args);
+
+            if (written < 0 || static_cast<std::size_t>(written) >= capacity_ - length_)
+            {
+                overflow_ = true;
+                return;
+            }
+            length_ += static_cast<std::size_t>(written);
+        }
+
+        std::size_t finish()
+        {
+            if (overflow_)
+            {
+                if (buffer_ != nullptr && capacity_ > 0)
+                {
+                    buffer_[0] = '\0';
+                }
+                return 0;
+            }
+            return length_;
+        }
+
+    private:
+        char *buffer_;
+        std::size_t capacity_;
+        std::size_t length_;
+        bool overflow_;
+    };
+
+    /**
+     * @brief Экранировать значение метки: обратную косую черту, кавычку и перевод строки.
+     *
+     * Слишком длинное значение обрезается.
+     */
+    void escapeLabel(const char *value, char *out, std::size_t capacity)
+    {
+        std::size_t length = 0;
+        for (; value != nullptr && *value != '\0'; ++value)
+        {
+            const char c = *value;
+            const bool special = c == '\\' || c == '"' || c == '\n';
+            if (length + (special ? 2 : 1) >= capacity)
+            {
+                break;
+            }
+            if (special)
+            {
+                out[length++] = '\\';
+            }
+            out[length++] = (c == '\n') ? 'n' : c;
+        }
+        out[length] = '\0';
+    }
+
+    void counter(TextWriter &out, const char *name, const char *help, const char *chip, uint64_t value)
+    {
+        out.print("# HELP %s %s\n# TYPE %s counter\n%s{chip=\"%s\"} %" PRIu64 "\n",
+                  name, help, name, name, chip, value);
+    }
+}
+
+EEPROMMetrics::EEPROMMetrics(const EEPROM25LC040A &eeprom, EEPROMClockFunction clock)
+    : eeprom_(eeprom),
+      meter_(eeprom.busStatistics(), clock),
+      operations_{},
+      pageWrites_{}
+{
+}
+
+void EEPROMMetrics::onOperationBegin(const EEPROMOperationInfo &)
+{
+    meter_.start();
+}
+
+void EEPROMMetrics::onOperationEnd(const EEPROMOperationInfo &info)
+{
+    const uint32_t duration = meter_.elapsedUs();
+
+    OperationStatistics &stats = operations_[indexOf(info.op)];
+    const std::size_t bytes = byteLength(info);
+    ++stats.count;
+    stats.bytes += bytes;
+    stats.latencySumUs += duration;
+
+    std::size_t bucket = 0;
+    while (bucket + 1 < LATENCY_BUCKETS && duration > (1u << bucket))
+    {
+        ++bucket;
+    }
+    ++stats.latency[bucket];
+
+    // Циклы записи - по затронутым страницам по порядку
+    const uint64_t cycles = meter_.busDelta().writeCycles;
+    if (isWrite(info.op) && cycles > 0 && bytes > 0 && info.address < EEPROM25LC040A::CAPACITY_BYTES)
+    {
+        const std::size_t first = info.address / PAGE;
+        std::size_t last = (info.address + bytes - 1) / PAGE;
+        last = (last < PAGE_COUNT) ? last : PAGE_COUNT - 1;
+        const std::size_t pages = last - first + 1;
+
+        for (uint64_t cycle = 0; cycle < cycles; ++cycle)
+        {
+            ++pageWrites_[first + cycle % pages];
+        }
+    }
+}
+
+const EEPROMMetrics::OperationStatistics &EEPROMMetrics::operation(EEPROMOperation op) const
+{
+    return operations_[indexOf(op)];
+}
+
+/**
+ * @brief Оценка квантиля длительности по гистограмме.
+ */
+uint64_t EEPROMMetrics::latencyQuantileUs(EEPROMOperation op, double quantile) const
+{
+    const OperationStatistics &stats = operation(op);
+    if (stats.count == 0)
+    {
+        return 0;
+    }
+
+    // Номер отсчёта, на который приходится квантиль (с 1)
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(stats.count) + 0.999999);
+    rank = (rank == 0) ? 1 : rank;
+
+    uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < LATENCY_BUCKETS; ++bucket)
+    {
+        seen += stats.latency[bucket];
+        if (seen >= rank)
+        {
+            return uint64_t{1} << bucket;
+        }
+    }
+
+    return uint64_t{1} << (LATENCY_BUCKETS - 1);
+}
+
+std::size_t EEPROMMetrics::indexOf(EEPROMOperation op)
+{
+    const std::size_t index = static_cast<std::size_t>(op) - 1;
+    return (index < OPERATION_COUNT) ? index : 0;
+}
+
+/**
+ * @brief Вывести метрики в текстовом формате Prometheus.
+ */
+std::size_t formatPrometheus(const EEPROMMetrics &metrics,
+                             const EEPROMShadow::Statistics *shadow,
+                             const char *chip,
+                             char *buffer,
+                             std::size_t capacity)
+{
+    TextWriter out(buffer, capacity);
+
+    char label[64];
+    escapeLabel(chip, label, sizeof(label));
+    chip = label;
+
+    // Операции
+    out.print("# HELP eeprom_operations_total EEPROM API calls by operation.\n"
+              "# TYPE eeprom_operations_total counter\n");
+    for (EEPROMOperation op : OPERATIONS)
+    {
+        out.print("eeprom_operations_total{chip=\"%s\",op=\"%s\"} %" PRIu64 "\n",
+                  chip, operationName(op), metrics.operation(op).count);
+    }
+
+    out.print("# HELP eeprom_operation_bytes_total Bytes addressed by EEPROM API calls.\n"
+              "# TYPE eeprom_operation_bytes_total counter\n");
+    for (EEPROMOperation op : OPERATIONS)
+    {
+        out.print("eeprom_operation_bytes_total{chip=\"%s\",op=\"%s\"} %" PRIu64 "\n",
+                  chip, operationName(op), metrics.operation(op).bytes);
+    }
+
+    // Длительность: гистограмма и оценки квантилей
+    out.print("# HELP eeprom_operation_duration_microseconds EEPROM API call duration.\n"
+              "# TYPE eeprom_operation_duration_microseconds histogram\n");
+    for (EEPROMOperation op : OPERATIONS)
+    {
+        const EEPROMMetrics::OperationStatistics &stats = metrics.operation(op);
+        if (stats.count == 0)
+        {
+            continue;
+        }
+
+        uint64_t cumulative = 0;
+        for (std::size_t bucket = 0; bucket + 1 < EEPROMMetrics::LATENCY_BUCKETS; ++bucket)
+        {
+            cumulative += stats.latency[bucket];
+            out.print("eeprom_operation_duration_microseconds_bucket{chip=\"%s\",op=\"%s\",le=\"%" PRIu64 "\"} %" PRIu64 "\n",
+                      chip, operationName(op), uint64_t{1} << bucket, cumulative);
+        }
+        out.print("eeprom_operation_duration_microseconds_bucket{chip=\"%s\",op=\"%s\",le=\"+Inf\"} %" PRIu64 "\n"
+                  "eeprom_operation_duration_microseconds_sum{chip=\"%s\",op=\"%s\"} %" PRIu64 "\n"
+                  "eeprom_operation_duration_microseconds_count{chip=\"%s\",op=\"%s\"} %" PRIu64 "\n",
+                  chip, operationName(op), stats.count,
+                  chip, operationName(op), stats.latencySumUs,
+                  chip, operationName(op), stats.count);
+    }
+
+    out.print("# HELP eeprom_operation_duration_quantile_microseconds Duration quantile estimated from the histogram (bucket upper bound).\n"
+              "# TYPE eeprom_operation_duration_quantile_microseconds gauge\n");
+    for (EEPROMOperation op : OPERATIONS)
+    {
+        if (metrics.operation(op).count == 0)
+        {
+            continue;
+        }
+        for (double quantile : QUANTILES)
+        {
+            out.print("eeprom_operation_duration_quantile_microseconds{chip=\"%s\",op=\"%s\",quantile=\"%g\"} %" PRIu64 "\n",
+                      chip, operationName(op), quantile, metrics.latencyQuantileUs(op, quantile));
+        }
+    }
+
+    // Шина
+    const EEPROM25LC040A::BusStatistics &bus = metrics.eeprom().busStatistics();
+    counter(out, "eeprom_bus_frames_total", "SPI frames (CS assertions).", chip, bus.frames);
+    counter(out, "eeprom_bus_bytes_total", "Bytes clocked on the SPI bus.", chip, bus.bytes);
+    counter(out, "eeprom_write_cycles_total", "Internal write cycles (tWC) started.", chip, bus.writeCycles);
+    counter(out, "eeprom_status_polls_total", "Status register reads while waiting for WIP.", chip, bus.statusPolls);
+    counter(out, "eeprom_wait_microseconds_total", "Time spent in delay_us() waiting for WIP.", chip, bus.delayUs);
+
+    // Износ страниц
+    out.print("# HELP eeprom_page_writes_total Write cycles attributed to each page.\n"
+              "# TYPE eeprom_page_writes_total counter\n");
+    for (std::size_t page = 0; page < EEPROMMetrics::PAGE_COUNT; ++page)
+    {
+        out.print("eeprom_page_writes_total{chip=\"%s\",page=\"%zu\"} %" PRIu64 "\n",
+                  chip, page, metrics.pageWrites(page));
+    }
+
+    // Зеркало
+    if (shadow != nullptr)
+    {
+        counter(out, "eeprom_shadow_coherency_hits_total", "Pages confirmed by the coherency table.", chip, shadow->coherencyHits);
+        counter(out, "eeprom_shadow_coherency_misses_total", "Pages reloaded after a coherency table mismatch.", chip, shadow->coherencyMisses);
+        counter(out, "eeprom_shadow_pages_programmed_total", "Pages written back by the shadow.", chip, shadow->pagesProgrammed);
+        counter(out, "eeprom_shadow_pages_skipped_total", "Clean pages skipped during write-back.", chip, shadow->pagesSkipped);
+    }
+
+    return out.finish();
+}
@@ -0,0 +1,45 @@
+#include "eeprom_metrics_file.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Атомарно записать текст метрик в файл.
+ */
+bool writeMetricsFile(const char *path, const char *text, std::size_t length)
+{
+    if (path == nullptr || (text == nullptr && length > 0))
+    {
+        return false;
+    }
+
+    // Временный файл в том же каталоге: rename() атомарен только в пределах файловой системы;
+    // уникальное имя - чтобы одновременные писатели не мешали друг другу
+    std::string temporary = std::string(path) + ".XXXXXX";
+    const int descriptor = mkstemp(&temporary[0]);
+    if (descriptor < 0)
+    {
+        return false;
+    }
+
+    // mkstemp создаёт файл с правами 0600 - коллектор может работать от другого пользователя
+    std::FILE *file = (fchmod(descriptor, 0644) == 0) ? fdopen(descriptor, "wb") : nullptr;
+    if (file == nullptr)
+    {
+        close(descriptor);
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    const bool written = std::fwrite(text, 1, length, file) == length;
+    const bool closed = std::fclose(file) == 0;
+    if (!written || !closed || std::rename(temporary.c_str(), path) != 0)
+    {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,50 @@
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @file eeprom_no_heap.cpp
+ * @brief Запрет динамической памяти для сборки EEPROM_NO_HEAP.
+ *
+ * Подключается к прошивке вместо стандартного распределителя:
+ * любое обращение к operator new аварийно завершает программу.
+ * Цель eeprom_no_heap_check собирается с этим файлом и выполняет
+ * классы библиотеки eeprom на симуляторе, поэтому случайное выделение
+ * памяти в пути устройства обнаруживается при запуске ctest.
+ */
+
+void *operator new(std::size_t)
+{
+    std::abort();
+}
+
+void *operator new[](std::size_t)
+{
+    std::abort();
+}
+
+void *operator new(std::size_t, const std::nothrow_t &) noexcept
+{
+    return nullptr;
+}
+
+void *operator new[](std::size_t, const std::nothrow_t &) noexcept
+{
+    return nullptr;
+}
+
+void operator delete(void *) noexcept
+{
+}
+
+void operator delete[](void *) noexcept
+{
+}
+
+void operator delete(void *, std::size_t) noexcept
+{
+}
+
+void operator delete[](void *, std::size_t) noexcept
+{
+}
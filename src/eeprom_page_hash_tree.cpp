@@ -0,0 +1,271 @@
+#include "eeprom_page_hash_tree.hpp"
+#include "eeprom_checksum.hpp"
+#include <algorithm>
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+
+    /**
+     * @brief Проверить параметры дерева.
+     *
+     * Количество страниц — степень двойки, защищаемые страницы
+     * и область дерева помещаются на микросхеме и не пересекаются.
+     */
+    bool validLayout(std::size_t firstPage, std::size_t pageCount, std::size_t treeAddress)
+    {
+        constexpr std::size_t MAX_PAGES = EEPROMPageHashTree::MAX_PAGES;
+        constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+
+        if (pageCount == 0 || pageCount > MAX_PAGES || (pageCount & (pageCount - 1)) != 0)
+        {
+            return false;
+        }
+        if (firstPage >= MAX_PAGES || pageCount > MAX_PAGES - firstPage)
+        {
+            return false;
+        }
+
+        const std::size_t treeSize = (2 * pageCount - 1) * EEPROMPageHashTree::NODE_SIZE;
+        if (treeAddress >= CAPACITY || treeSize > CAPACITY - treeAddress)
+        {
+            return false;
+        }
+
+        const std::size_t begin = firstPage * PAGE;
+        const std::size_t end = (firstPage + pageCount) * PAGE;
+        return treeAddress + treeSize <= begin || treeAddress >= end;
+    }
+}
+
+EEPROMPageHashTree::EEPROMPageHashTree(EEPROM25LC040A &eeprom,
+                                       std::size_t firstPage,
+                                       std::size_t pageCount,
+                                       std::size_t treeAddress)
+    : eeprom_(eeprom),
+      firstPage_(firstPage),
+      pageCount_(0),
+      treeAddress_(treeAddress),
+      nodes_{}
+{
+    if (validLayout(firstPage, pageCount, treeAddress))
+    {
+        pageCount_ = pageCount;
+    }
+}
+
+/**
+ * @brief Построить дерево по всем страницам и записать его.
+ */
+void EEPROMPageHashTree::build()
+{
+    if (!valid())
+    {
+        return;
+    }
+
+    uint8_t data[EEPROM25LC040A::CAPACITY_BYTES];
+    eeprom_.readArray(firstPage_ * PAGE, data, pageCount_ * PAGE);
+
+    // Листья
+    const std::size_t leaves = pageCount_ - 1;
+    for (std::size_t i = 0; i < pageCount_; ++i)
+    {
+        nodes_[leaves + i] = hashPage(firstPage_ + i, data + i * PAGE);
+    }
+
+    // Внутренние узлы снизу вверх
+    for (std::size_t i = leaves; i-- > 0;)
+    {
+        nodes_[i] = hashNode(nodes_[2 * i + 1], nodes_[2 * i + 2]);
+    }
+
+    storeNodes((uint64_t{1} << nodeCount()) - 1);
+}
+
+/**
+ * @brief Загрузить дерево с микросхемы.
+ */
+bool EEPROMPageHashTree::load()
+{
+    if (!valid())
+    {
+        return false;
+    }
+
+    uint8_t raw[(2 * MAX_PAGES - 1) * NODE_SIZE];
+    eeprom_.readArray(treeAddress_, raw, treeSize());
+
+    for (std::size_t i = 0; i < nodeCount(); ++i)
+    {
+        const uint8_t *p = raw + i * NODE_SIZE;
+        nodes_[i] = static_cast<uint32_t>(p[0]) |
+                    static_cast<uint32_t>(p[1]) << 8 |
+                    static_cast<uint32_t>(p[2]) << 16 |
+                    static_cast<uint32_t>(p[3]) << 24;
+    }
+
+    for (std::size_t i = 0; i < pageCount_ - 1; ++i)
+    {
+        if (nodes_[i] != hashNode(nodes_[2 * i + 1], nodes_[2 * i + 2]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Обновить хеши после изменения области.
+ */
+void EEPROMPageHashTree::update(std::size_t address, std::size_t length)
+{
+    std::size_t first = 0;
+    std::size_t last = 0;
+    if (!pageRange(address, length, first, last))
+    {
+        return;
+    }
+
+    // Читаем только затронутые страницы одним кадром
+    uint8_t data[EEPROM25LC040A::CAPACITY_BYTES];
+    eeprom_.readArray((firstPage_ + first) * PAGE, data, (last - first + 1) * PAGE);
+
+    uint64_t changed = 0;
+    for (std::size_t i = first; i <= last; ++i)
+    {
+        std::size_t node = pageCount_ - 1 + i;
+        const uint32_t leaf = hashPage(firstPage_ + i, data + (i - first) * PAGE);
+        if (nodes_[node] == leaf)
+        {
+            continue;
+        }
+
+        nodes_[node] = leaf;
+        changed |= uint64_t{1} << node;
+
+        // Путь до корня: O(log n) узлов
+        while (node > 0)
+        {
+            node = (node - 1) / 2;
+            nodes_[node] = hashNode(nodes_[2 * node + 1], nodes_[2 * node + 2]);
+            changed |= uint64_t{1} << node;
+        }
+    }
+
+    storeNodes(changed);
+}
+
+/**
+ * @brief Записать данные и обновить дерево.
+ */
+void EEPROMPageHashTree::write(std::size_t address,
+                               const uint8_t *buffer,
+                               std::size_t length)
+{
+    eeprom_.writeArray(address, buffer, length);
+    update(address, length);
+}
+
+/**
+ * @brief Проверить целостность области.
+ */
+bool EEPROMPageHashTree::verify(std::size_t address, std::size_t length) const
+{
+    if (!valid())
+    {
+        return false;
+    }
+
+    std::size_t first = 0;
+    std::size_t last = 0;
+    if (!pageRange(address, length, first, last))
+    {
+        return true; // Область не защищена деревом
+    }
+
+    uint8_t data[EEPROM25LC040A::CAPACITY_BYTES];
+    eeprom_.readArray((firstPage_ + first) * PAGE, data, (last - first + 1) * PAGE);
+
+    for (std::size_t i = first; i <= last; ++i)
+    {
+        if (nodes_[pageCount_ - 1 + i] != hashPage(firstPage_ + i, data + (i - first) * PAGE))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool EEPROMPageHashTree::pageRange(std::size_t address,
+                                   std::size_t length,
+                                   std::size_t &first,
+                                   std::size_t &last) const
+{
+    if (!valid() || length == 0)
+    {
+        return false;
+    }
+
+    const std::size_t begin = firstPage_ * PAGE;
+    const std::size_t end = (firstPage_ + pageCount_) * PAGE;
+    if (address >= end || address + length <= begin)
+    {
+        return false;
+    }
+
+    first = (std::max(address, begin) - begin) / PAGE;
+    last = (std::min(address + length, end) - 1 - begin) / PAGE;
+    return true;
+}
+
+uint32_t EEPROMPageHashTree::hashPage(std::size_t page, const uint8_t *data)
+{
+    // Номер страницы в начальном значении: перестановка страниц тоже обнаруживается
+    return crc32(data, PAGE, static_cast<uint32_t>(page));
+}
+
+uint32_t EEPROMPageHashTree::hashNode(uint32_t left, uint32_t right)
+{
+    const uint8_t pair[2 * NODE_SIZE] = {
+        static_cast<uint8_t>(left), static_cast<uint8_t>(left >> 8),
+        static_cast<uint8_t>(left >> 16), static_cast<uint8_t>(left >> 24),
+        static_cast<uint8_t>(right), static_cast<uint8_t>(right >> 8),
+        static_cast<uint8_t>(right >> 16), static_cast<uint8_t>(right >> 24)};
+    return crc32(pair, sizeof(pair));
+}
+
+void EEPROMPageHashTree::storeNodes(uint64_t mask)
+{
+    // Соседние изменённые узлы записываются одним вызовом writeArray
+    std::size_t i = 0;
+    while (i < nodeCount())
+    {
+        if ((mask & (uint64_t{1} << i)) == 0)
+        {
+            ++i;
+            continue;
+        }
+
+        std::size_t run_end = i;
+        while (run_end < nodeCount() && (mask & (uint64_t{1} << run_end)) != 0)
+        {
+            ++run_end;
+        }
+
+        uint8_t raw[(2 * MAX_PAGES - 1) * NODE_SIZE];
+        for (std::size_t n = i; n < run_end; ++n)
+        {
+            uint8_t *p = raw + (n - i) * NODE_SIZE;
+            p[0] = static_cast<uint8_t>(nodes_[n]);
+            p[1] = static_cast<uint8_t>(nodes_[n] >> 8);
+            p[2] = static_cast<uint8_t>(nodes_[n] >> 16);
+            p[3] = static_cast<uint8_t>(nodes_[n] >> 24);
+        }
+
+        eeprom_.writeArray(treeAddress_ + i * NODE_SIZE, raw, (run_end - i) * NODE_SIZE);
+        i = run_end;
+    }
+}
@@ -0,0 +1,257 @@
+#include "eeprom_patch.hpp"
+#include "eeprom_checksum.hpp"
+#include <cstring>
+
+namespace
+{
+    constexpr uint8_t MAGIC[4] = {'E', 'P', 'T', '1'};
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+
+    void storeLe16(uint8_t *data, std::size_t value)
+    {
+        data[0] = static_cast<uint8_t>(value & 0xFF);
+        data[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+    }
+
+    void storeLe32(uint8_t *data, uint32_t value)
+    {
+        storeLe16(data, value & 0xFFFF);
+        storeLe16(data + 2, value >> 16);
+    }
+
+    std::size_t loadLe16(const uint8_t *data)
+    {
+        return static_cast<std::size_t>(data[0]) | (static_cast<std::size_t>(data[1]) << 8);
+    }
+
+    uint32_t loadLe32(const uint8_t *data)
+    {
+        return static_cast<uint32_t>(loadLe16(data)) |
+               (static_cast<uint32_t>(loadLe16(data + 2)) << 16);
+    }
+
+    /**
+     * @brief CRC-32 содержимого микросхемы, считанного кадрами.
+     */
+    uint32_t chipCrc(const EEPROM25LC040A &eeprom)
+    {
+        constexpr std::size_t CHUNK = EEPROM25LC040A::CANCEL_CHUNK;
+        uint8_t chunk[CHUNK];
+        uint32_t crc = 0;
+
+        for (std::size_t address = 0; address < CAPACITY; address += CHUNK)
+        {
+            eeprom.readArray(address, chunk, CHUNK);
+            crc = crc32(chunk, CHUNK, crc);
+        }
+
+        return crc;
+    }
+
+    /**
+     * @brief Проверить структуру патча.
+     */
+    bool isValidPatch(const uint8_t *patch, std::size_t size)
+    {
+        if (patch == nullptr || size < PATCH_HEADER_SIZE ||
+            std::memcmp(patch, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            return false;
+        }
+
+        const std::size_t runs = loadLe16(patch + 12);
+        std::size_t position = PATCH_HEADER_SIZE;
+        std::size_t end_of_previous = 0;
+
+        for (std::size_t run = 0; run < runs; ++run)
+        {
+            if (size - position < PATCH_RUN_HEADER_SIZE)
+            {
+                return false;
+            }
+
+            const std::size_t offset = loadLe16(patch + position);
+            const std::size_t length = loadLe16(patch + position + 2);
+            position += PATCH_RUN_HEADER_SIZE;
+
+            if (length == 0 || offset < end_of_previous || offset >= CAPACITY ||
+                length > CAPACITY - offset || length > size - position)
+            {
+                return false;
+            }
+
+            end_of_previous = offset + length;
+            position += length;
+        }
+
+        return position == size;
+    }
+
+    /**
+     * @brief Накопитель изменений одной страницы.
+     */
+    struct PageBuilder
+    {
+        EEPROM25LC040A &eeprom;
+        std::size_t page;
+        uint8_t data[PAGE];
+        uint32_t mask; ///< Бит N - байт N страницы изменён
+
+        /**
+         * @brief Записать накопленные изменения страницы.
+         */
+        void commit()
+        {
+            if (mask == 0)
+            {
+                return;
+            }
+
+            std::size_t first = 0;
+            while (!(mask & (1u << first)))
+            {
+                ++first;
+            }
+            std::size_t last = PAGE - 1;
+            while (!(mask & (1u << last)))
+            {
+                --last;
+            }
+            const std::size_t length = last - first + 1;
+            const uint32_t span = ((1u << length) - 1) << first;
+
+            // Пропуски между участками внутри страницы дочитываются с микросхемы
+            if ((mask & span) != span)
+            {
+                uint8_t current[PAGE];
+                eeprom.readArray(page * PAGE + first, current + first, length);
+                for (std::size_t i = first; i <= last; ++i)
+                {
+                    if (!(mask & (1u << i)))
+                    {
+                        data[i] = current[i];
+                    }
+                }
+            }
+
+            eeprom.writeArray(page * PAGE + first, data + first, length);
+            mask = 0;
+        }
+    };
+}
+
+/**
+ * @brief Построить патч из исходного образа в новый.
+ */
+std::size_t makePatch(const uint8_t *base,
+                      const uint8_t *target,
+                      uint8_t *patch,
+                      std::size_t capacity)
+{
+    if (base == nullptr || target == nullptr || patch == nullptr ||
+        capacity < PATCH_HEADER_SIZE)
+    {
+        return 0;
+    }
+
+    std::memcpy(patch, MAGIC, sizeof(MAGIC));
+    storeLe32(patch + 4, crc32(base, CAPACITY));
+    storeLe32(patch + 8, crc32(target, CAPACITY));
+
+    std::size_t size = PATCH_HEADER_SIZE;
+    std::size_t runs = 0;
+    std::size_t address = 0;
+
+    while (address < CAPACITY)
+    {
+        if (base[address] == target[address])
+        {
+            ++address;
+            continue;
+        }
+
+        // Участок продолжается, пока разрыв не длиннее заголовка участка
+        const std::size_t start = address;
+        std::size_t end = address + 1;
+        std::size_t scan = end;
+        while (scan < CAPACITY && scan - end <= PATCH_RUN_HEADER_SIZE)
+        {
+            if (base[scan] != target[scan])
+            {
+                end = scan + 1;
+            }
+            ++scan;
+        }
+
+        const std::size_t length = end - start;
+        if (capacity - size < PATCH_RUN_HEADER_SIZE + length)
+        {
+            return 0;
+        }
+
+        storeLe16(patch + size, start);
+        storeLe16(patch + size + 2, length);
+        std::memcpy(patch + size + PATCH_RUN_HEADER_SIZE, target + start, length);
+        size += PATCH_RUN_HEADER_SIZE + length;
+        ++runs;
+        address = end;
+    }
+
+    storeLe16(patch + 12, runs);
+    return size;
+}
+
+/**
+ * @brief Применить патч к микросхеме.
+ */
+EEPROMPatchResult applyPatch(EEPROM25LC040A &eeprom, const uint8_t *patch, std::size_t size)
+{
+    if (!isValidPatch(patch, size))
+    {
+        return EEPROMPatchResult::BAD_FORMAT;
+    }
+
+    const uint32_t base_crc = loadLe32(patch + 4);
+    const uint32_t result_crc = loadLe32(patch + 8);
+
+    // Результат уже на микросхеме: повторная доставка или пустой патч
+    const uint32_t crc = chipCrc(eeprom);
+    if (crc == result_crc)
+    {
+        return EEPROMPatchResult::ALREADY_APPLIED;
+    }
+    if (crc != base_crc)
+    {
+        return EEPROMPatchResult::BASE_MISMATCH;
+    }
+
+    PageBuilder builder{eeprom, 0, {}, 0};
+    const std::size_t runs = loadLe16(patch + 12);
+    std::size_t position = PATCH_HEADER_SIZE;
+
+    for (std::size_t run = 0; run < runs; ++run)
+    {
+        const std::size_t offset = loadLe16(patch + position);
+        const std::size_t length = loadLe16(patch + position + 2);
+        const uint8_t *bytes = patch + position + PATCH_RUN_HEADER_SIZE;
+        position += PATCH_RUN_HEADER_SIZE + length;
+
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            const std::size_t address = offset + i;
+            if (address / PAGE != builder.page)
+            {
+                builder.commit();
+                builder.page = address / PAGE;
+            }
+
+            builder.data[address % PAGE] = bytes[i];
+            builder.mask |= 1u << (address % PAGE);
+        }
+    }
+    builder.commit();
+
+    return (chipCrc(eeprom) == result_crc) ? EEPROMPatchResult::APPLIED
+                                           : EEPROMPatchResult::VERIFY_FAILED;
+}
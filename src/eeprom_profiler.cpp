@@ -0,0 +1,203 @@
+#include "eeprom_profiler.hpp"
+#include <cinttypes>
+#include <cstdio>
+
+EEPROMCallSiteProfiler::EEPROMCallSiteProfiler(const EEPROM25LC040A &eeprom, EEPROMClockFunction clock)
+    : meter_(eeprom.busStatistics(), clock),
+      stack_{},
+      depth_(0),
+      sites_{},
+      siteCount_(0),
+      overflowed_(false)
+{
+}
+
+/**
+ * @brief Операция началась: запоминаем счётчики шины и время.
+ */
+void EEPROMCallSiteProfiler::onOperationBegin(const EEPROMOperationInfo &)
+{
+    meter_.start();
+}
+
+/**
+ * @brief Операция завершилась: относим её стоимость к месту вызова.
+ */
+void EEPROMCallSiteProfiler::onOperationEnd(const EEPROMOperationInfo &info)
+{
+    Site *site = findSite(info.op);
+    if (site == nullptr)
+    {
+        overflowed_ = true;
+        return;
+    }
+
+    SiteStatistics &stats = site->stats;
+    const EEPROMBusStatistics bus = meter_.busDelta();
+    ++stats.calls;
+    stats.clocks += bus.bytes * 8;
+    stats.frames += bus.frames;
+    stats.writeCycles += bus.writeCycles;
+    stats.statusPolls += bus.statusPolls;
+    stats.waitUs += bus.delayUs;
+    stats.wallUs += meter_.elapsedUs();
+}
+
+/**
+ * @brief Сбросить накопленные данные.
+ */
+void EEPROMCallSiteProfiler::clear()
+{
+    siteCount_ = 0;
+    overflowed_ = false;
+}
+
+/**
+ * @brief Вывести данные в формате folded stacks.
+ */
+std::size_t EEPROMCallSiteProfiler::dumpFolded(char *buffer,
+                                               std::size_t capacity,
+                                               Metric metric) const
+{
+    if (buffer == nullptr || capacity == 0)
+    {
+        return 0;
+    }
+
+    std::size_t length = 0;
+    buffer[0] = '\0';
+
+    for (std::size_t i = 0; i < siteCount_; ++i)
+    {
+        const Site &site = sites_[i];
+        const uint64_t value = metricValue(site.stats, metric);
+        if (value == 0)
+        {
+            continue;
+        }
+
+        // Строка собирается после уже выведенных; при нехватке места откатывается
+        std::size_t position = length;
+        bool fits = true;
+        auto append = [&](int written) {
+            if (written < 0 || static_cast<std::size_t>(written) >= capacity - position)
+            {
+                fits = false;
+                return;
+            }
+            position += static_cast<std::size_t>(written);
+        };
+
+        if (site.depth == 0)
+        {
+            append(std::snprintf(buffer + position, capacity - position, "untagged;"));
+        }
+        for (std::size_t d = 0; d < site.depth && fits; ++d)
+        {
+            const Frame &frame = site.frames[d];
+            if (frame.isTag)
+            {
+                append(std::snprintf(buffer + position, capacity - position, "%s;",
+                                     static_cast<const char *>(frame.pointer)));
+            }
+            else
+            {
+                append(std::snprintf(buffer + position, capacity - position, "0x%" PRIxPTR ";",
+                                     reinterpret_cast<uintptr_t>(frame.pointer)));
+            }
+        }
+        if (fits)
+        {
+            append(std::snprintf(buffer + position, capacity - position, "%s %" PRIu64 "\n",
+                                 operationName(site.op), value));
+        }
+
+        if (fits)
+        {
+            length = position;
+        }
+        buffer[length] = '\0';
+    }
+
+    return length;
+}
+
+void EEPROMCallSiteProfiler::push(const void *pointer, bool isTag)
+{
+    if (depth_ < MAX_DEPTH)
+    {
+        stack_[depth_] = Frame{pointer, isTag};
+    }
+    ++depth_;
+}
+
+void EEPROMCallSiteProfiler::pop()
+{
+    if (depth_ > 0)
+    {
+        --depth_;
+    }
+}
+
+/**
+ * @brief Найти или добавить место вызова для текущего стека.
+ */
+EEPROMCallSiteProfiler::Site *EEPROMCallSiteProfiler::findSite(EEPROMOperation op)
+{
+    const std::size_t depth = (depth_ < MAX_DEPTH) ? depth_ : MAX_DEPTH;
+
+    for (std::size_t i = 0; i < siteCount_; ++i)
+    {
+        Site &site = sites_[i];
+        if (site.op != op || site.depth != depth)
+        {
+            continue;
+        }
+
+        bool same = true;
+        for (std::size_t d = 0; d < depth && same; ++d)
+        {
+            same = site.frames[d].pointer == stack_[d].pointer &&
+                   site.frames[d].isTag == stack_[d].isTag;
+        }
+        if (same)
+        {
+            return &site;
+        }
+    }
+
+    if (siteCount_ == MAX_SITES)
+    {
+        return nullptr;
+    }
+
+    Site &site = sites_[siteCount_++];
+    for (std::size_t d = 0; d < depth; ++d)
+    {
+        site.frames[d] = stack_[d];
+    }
+    site.depth = depth;
+    site.op = op;
+    site.stats = SiteStatistics{};
+    return &site;
+}
+
+uint64_t EEPROMCallSiteProfiler::metricValue(const SiteStatistics &stats, Metric metric)
+{
+    switch (metric)
+    {
+    case Metric::CALLS:
+        return stats.calls;
+    case Metric::CLOCKS:
+        return stats.clocks;
+    case Metric::FRAMES:
+        return stats.frames;
+    case Metric::WRITE_CYCLES:
+        return stats.writeCycles;
+    case Metric::WAIT_US:
+        return stats.waitUs;
+    case Metric::WALL_US:
+        return stats.wallUs;
+    }
+    return 0;
+}
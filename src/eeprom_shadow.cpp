@@ -0,0 +1,513 @@
+#include "eeprom_shadow.hpp"
+#include "eeprom_checksum.hpp"
+#include <cstring>
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+}
+
+EEPROMShadow::EEPROMShadow(EEPROM25LC040A &eeprom)
+    : eeprom_(eeprom),
+      subscriptions_{},
+      tableEnabled_(false),
+      tableAddress_(0),
+      tablePages_(0),
+      pageChecksums_{},
+      clock_(nullptr),
+      flushDelayUs_(0),
+      bufferedPages_(0),
+      bufferedDeadline_(0),
+      groups_{},
+      groupCount_(0),
+      stats_{}
+{
+    std::memset(image_, 0xFF, sizeof(image_));
+    std::memset(committed_, 0xFF, sizeof(committed_));
+}
+
+/**
+ * @brief Загрузить содержимое микросхемы одним чтением.
+ */
+void EEPROMShadow::load()
+{
+    // Одна транзакция READ на всю микросхему
+    eeprom_.readArray(0, committed_, sizeof(committed_));
+    std::memcpy(image_, committed_, sizeof(image_));
+
+    if (tableEnabled_)
+    {
+        refreshPageChecksums();
+    }
+}
+
+/**
+ * @brief Маска страниц, отличающихся от записанного образа.
+ */
+uint32_t EEPROMShadow::dirtyPages() const
+{
+    uint32_t mask = 0;
+
+    for (std::size_t page = 0; page < PAGE_COUNT; ++page)
+    {
+        if (isPageDirty(page))
+        {
+            mask |= 1u << page;
+        }
+    }
+
+    return mask;
+}
+
+/**
+ * @brief Записать на микросхему все изменённые страницы.
+ */
+std::size_t EEPROMShadow::sync()
+{
+    return flush(~uint32_t{0});
+}
+
+/**
+ * @brief Записать данные с заданным уровнем сохранности.
+ */
+void EEPROMShadow::write(std::size_t address,
+                         const uint8_t *buffer,
+                         std::size_t length,
+                         Durability durability)
+{
+    if (buffer == nullptr || length == 0 || address >= size())
+    {
+        return;
+    }
+    length = (length < size() - address) ? length : size() - address;
+
+    uint32_t pages = 0;
+    for (std::size_t page = address / PAGE; page <= (address + length - 1) / PAGE; ++page)
+    {
+        pages |= 1u << page;
+    }
+
+    // Страница ждёт записи в группе до барьера - сначала записываем
+    // её прежнее содержимое, чтобы новые байты не обогнали барьер
+    if ((pages & groupedPages()) != 0)
+    {
+        flush(pages & groupedPages());
+    }
+
+    std::memcpy(image_ + address, buffer, length);
+
+    // Без источника времени срок отложенной записи не отследить
+    if (durability == Durability::BUFFERED && clock_ == nullptr)
+    {
+        durability = Durability::DURABLE;
+    }
+
+    switch (durability)
+    {
+    case Durability::VOLATILE:
+        break;
+
+    case Durability::BUFFERED:
+        // Срок отсчитывается от первой отложенной записи после сброса
+        if (bufferedPages_ == 0)
+        {
+            bufferedDeadline_ = now() + flushDelayUs_;
+        }
+        bufferedPages_ |= pages;
+        break;
+
+    case Durability::DURABLE:
+        flush(pages);
+        break;
+    }
+}
+
+/**
+ * @brief Задать источник времени и предельную задержку отложенной записи.
+ */
+void EEPROMShadow::setFlushDelay(EEPROMClockFunction clock, uint32_t delayUs)
+{
+    clock_ = clock;
+    flushDelayUs_ = delayUs;
+
+    if (bufferedPages_ == 0)
+    {
+        return;
+    }
+
+    // Отложенные страницы: без источника времени - сразу, иначе срок по новым часам
+    if (clock_ == nullptr)
+    {
+        flush(bufferedPages_);
+    }
+    else
+    {
+        bufferedDeadline_ = now() + flushDelayUs_;
+    }
+}
+
+/**
+ * @brief Записать отложенные страницы, срок которых истёк.
+ */
+std::size_t EEPROMShadow::poll()
+{
+    // Разность по модулю 2^32 - переполнение часов не мешает
+    if (bufferedPages_ == 0 ||
+        static_cast<int32_t>(now() - bufferedDeadline_) < 0)
+    {
+        return 0;
+    }
+
+    return flush(bufferedPages_);
+}
+
+/**
+ * @brief Барьер упорядочивания записи.
+ */
+void EEPROMShadow::barrier()
+{
+    // Изменения до барьера, ещё не вошедшие в закрытые группы
+    const uint32_t pages = dirtyPages() & ~groupedPages();
+    if (pages == 0)
+    {
+        return;
+    }
+
+    if (groupCount_ == MAX_BARRIERS)
+    {
+        // Нет места для новой группы - записываем все закрытые по порядку
+        flush(groups_[groupCount_ - 1]);
+    }
+
+    groups_[groupCount_++] = pages;
+}
+
+std::size_t EEPROMShadow::flush(uint32_t mask)
+{
+    std::size_t programmed = 0;
+
+    // Группы, закрытые барьерами, записываются строго по порядку:
+    // сначала все группы до последней, затронутой маской, а если
+    // маска содержит изменения после последнего барьера - все группы
+    std::size_t through = 0;
+    if ((mask & ~groupedPages() & dirtyPages()) != 0)
+    {
+        through = groupCount_;
+    }
+    else
+    {
+        for (std::size_t i = 0; i < groupCount_; ++i)
+        {
+            if ((groups_[i] & mask) != 0)
+            {
+                through = i + 1;
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < through; ++i)
+    {
+        programmed += commitOrdered(groups_[i]);
+        bufferedPages_ &= ~groups_[i];
+    }
+
+    for (std::size_t i = through; i < groupCount_; ++i)
+    {
+        groups_[i - through] = groups_[i];
+    }
+    groupCount_ -= through;
+
+    programmed += commitOrdered(mask);
+
+    // Записанные страницы больше не ждут отложенного сброса
+    bufferedPages_ &= ~mask;
+
+    if (programmed > 0)
+    {
+        dispatchChanges();
+    }
+
+    return programmed;
+}
+
+std::size_t EEPROMShadow::commitOrdered(uint32_t mask)
+{
+    // Сначала данные (суммы заносятся в таблицу образа), затем сама таблица
+    std::size_t programmed = commitPages(mask & ~tablePages_);
+    if (tableEnabled_ && programmed > 0)
+    {
+        programmed += commitPages(tablePages_);
+    }
+    else
+    {
+        programmed += commitPages(mask & tablePages_);
+    }
+
+    return programmed;
+}
+
+uint32_t EEPROMShadow::groupedPages() const
+{
+    uint32_t pages = 0;
+    for (std::size_t i = 0; i < groupCount_; ++i)
+    {
+        pages |= groups_[i];
+    }
+    return pages;
+}
+
+uint32_t EEPROMShadow::now() const
+{
+    return clock_ != nullptr ? clock_() : 0;
+}
+
+/**
+ * @brief Подписаться на изменения области.
+ */
+int EEPROMShadow::subscribe(std::size_t address,
+                            std::size_t length,
+                            ChangeCallback callback,
+                            void *context)
+{
+    if (callback == nullptr || length == 0)
+    {
+        return -1;
+    }
+
+    for (std::size_t i = 0; i < MAX_SUBSCRIPTIONS; ++i)
+    {
+        Subscription &sub = subscriptions_[i];
+        if (sub.callback == nullptr)
+        {
+            sub = Subscription{address, length, callback, context, 0, 0, false};
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Отменить подписку.
+ */
+void EEPROMShadow::unsubscribe(int id)
+{
+    if (id >= 0 && static_cast<std::size_t>(id) < MAX_SUBSCRIPTIONS)
+    {
+        subscriptions_[id].callback = nullptr;
+    }
+}
+
+/**
+ * @brief Включить таблицу контрольных сумм страниц на микросхеме.
+ */
+void EEPROMShadow::enableCoherencyTable(std::size_t tableAddress)
+{
+    if (tableAddress + PAGE_COUNT > size())
+    {
+        return;
+    }
+
+    tableEnabled_ = true;
+    tableAddress_ = tableAddress;
+    tablePages_ = 0;
+    for (std::size_t page = tableAddress / PAGE; page <= (tableAddress + PAGE_COUNT - 1) / PAGE; ++page)
+    {
+        tablePages_ |= 1u << page;
+    }
+
+    refreshPageChecksums();
+}
+
+/**
+ * @brief Проверить, не изменил ли микросхему внешний программатор.
+ */
+uint32_t EEPROMShadow::checkCoherency()
+{
+    if (!tableEnabled_)
+    {
+        return 0;
+    }
+
+    // Один короткий кадр вместо чтения всей микросхемы
+    uint8_t table[PAGE_COUNT];
+    eeprom_.readArray(tableAddress_, table, PAGE_COUNT);
+
+    uint32_t reloaded = 0;
+    for (std::size_t page = 0; page < PAGE_COUNT; ++page)
+    {
+        if ((tablePages_ & (1u << page)) != 0)
+        {
+            continue;
+        }
+        if (table[page] == pageChecksums_[page])
+        {
+            ++stats_.coherencyHits;
+            continue;
+        }
+        ++stats_.coherencyMisses;
+
+        const std::size_t base = page * PAGE;
+        uint8_t fresh[PAGE];
+        eeprom_.readArray(base, fresh, PAGE);
+
+        for (std::size_t i = 0; i < PAGE; ++i)
+        {
+            if (fresh[i] != committed_[base + i])
+            {
+                noteChange(base + i);
+            }
+        }
+
+        std::memcpy(committed_ + base, fresh, PAGE);
+        std::memcpy(image_ + base, fresh, PAGE);
+        pageChecksums_[page] = crc8(fresh, PAGE);
+        reloaded |= 1u << page;
+    }
+
+    // Записанный образ таблицы - как на микросхеме. Если программатор
+    // оставил неверную сумму, исправленное значение уйдёт при sync()
+    std::memcpy(committed_ + tableAddress_, table, PAGE_COUNT);
+    for (std::size_t page = 0; page < PAGE_COUNT; ++page)
+    {
+        const bool own_page = (tablePages_ & (1u << page)) != 0;
+        image_[tableAddress_ + page] = own_page ? table[page] : pageChecksums_[page];
+    }
+
+    if (reloaded != 0)
+    {
+        dispatchChanges();
+    }
+
+    return reloaded;
+}
+
+std::size_t EEPROMShadow::commitPages(uint32_t mask)
+{
+    std::size_t programmed = 0;
+
+    for (std::size_t page = 0; page < PAGE_COUNT; ++page)
+    {
+        if ((mask & (1u << page)) == 0)
+        {
+            continue;
+        }
+
+        if (!isPageDirty(page))
+        {
+            ++stats_.pagesSkipped;
+            continue;
+        }
+
+        commitPage(page);
+        ++programmed;
+        ++stats_.pagesProgrammed;
+
+        if (tableEnabled_ && (tablePages_ & (1u << page)) == 0)
+        {
+            updatePageChecksum(page);
+        }
+    }
+
+    return programmed;
+}
+
+void EEPROMShadow::refreshPageChecksums()
+{
+    for (std::size_t page = 0; page < PAGE_COUNT; ++page)
+    {
+        if ((tablePages_ & (1u << page)) == 0)
+        {
+            updatePageChecksum(page);
+        }
+    }
+}
+
+void EEPROMShadow::updatePageChecksum(std::size_t page)
+{
+    pageChecksums_[page] = crc8(committed_ + page * PAGE, PAGE);
+    image_[tableAddress_ + page] = pageChecksums_[page];
+}
+
+bool EEPROMShadow::isPageDirty(std::size_t page) const
+{
+    const std::size_t base = page * EEPROM25LC040A::PAGE_SIZE;
+    return std::memcmp(image_ + base, committed_ + base, EEPROM25LC040A::PAGE_SIZE) != 0;
+}
+
+void EEPROMShadow::commitPage(std::size_t page)
+{
+    const std::size_t base = page * EEPROM25LC040A::PAGE_SIZE;
+
+    // Ищем первый и последний изменённый байт страницы
+    std::size_t first = 0;
+    while (first < EEPROM25LC040A::PAGE_SIZE && image_[base + first] == committed_[base + first])
+    {
+        ++first;
+    }
+
+    if (first == EEPROM25LC040A::PAGE_SIZE)
+    {
+        return; // Страница не изменена
+    }
+
+    std::size_t last = EEPROM25LC040A::PAGE_SIZE - 1;
+    while (image_[base + last] == committed_[base + last])
+    {
+        --last;
+    }
+
+    // Участок целиком лежит в одной странице - один кадр WRITE и один tWC
+    const std::size_t length = last - first + 1;
+    eeprom_.writeArray(base + first, image_ + base + first, length);
+
+    for (std::size_t i = first; i <= last; ++i)
+    {
+        if (image_[base + i] != committed_[base + i])
+        {
+            noteChange(base + i);
+        }
+    }
+
+    std::memcpy(committed_ + base + first, image_ + base + first, length);
+}
+
+void EEPROMShadow::noteChange(std::size_t address)
+{
+    for (Subscription &sub : subscriptions_)
+    {
+        if (sub.callback == nullptr ||
+            address < sub.address || address >= sub.address + sub.length)
+        {
+            continue;
+        }
+
+        // Страницы записываются не по возрастанию адреса (группы барьеров,
+        // таблица сумм после данных), поэтому границы - минимум и максимум
+        if (!sub.changed)
+        {
+            sub.changedFirst = address;
+            sub.changedLast = address;
+            sub.changed = true;
+        }
+        sub.changedFirst = (address < sub.changedFirst) ? address : sub.changedFirst;
+        sub.changedLast = (address > sub.changedLast) ? address : sub.changedLast;
+    }
+}
+
+void EEPROMShadow::dispatchChanges()
+{
+    for (Subscription &sub : subscriptions_)
+    {
+        if (!sub.changed)
+        {
+            continue;
+        }
+
+        sub.changed = false;
+        if (sub.callback != nullptr)
+        {
+            sub.callback(sub.changedFirst, sub.changedLast - sub.changedFirst + 1, sub.context);
+        }
+    }
+}
@@ -0,0 +1,121 @@
+#include "eeprom_startup_loader.hpp"
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t microsecondsBetween(Clock::time_point from, Clock::time_point to)
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+    }
+
+    /**
+     * @brief Дожидается запущенных потоков при любом выходе из области.
+     */
+    class JoinGuard
+    {
+    public:
+        explicit JoinGuard(std::vector<std::thread> &threads) : threads_(threads) {}
+
+        ~JoinGuard()
+        {
+            for (std::thread &thread : threads_)
+            {
+                if (thread.joinable())
+                {
+                    thread.join();
+                }
+            }
+        }
+
+        JoinGuard(const JoinGuard &) = delete;
+        JoinGuard &operator=(const JoinGuard &) = delete;
+
+    private:
+        std::vector<std::thread> &threads_;
+    };
+}
+
+EEPROMStartupLoader::EEPROMStartupLoader()
+    : buses_(),
+      results_(),
+      totalTimeUs_(0)
+{
+}
+
+/**
+ * @brief Добавить шину.
+ */
+std::size_t EEPROMStartupLoader::addBus()
+{
+    buses_.emplace_back();
+    return buses_.size() - 1;
+}
+
+/**
+ * @brief Добавить микросхему на шину.
+ */
+bool EEPROMStartupLoader::addChip(std::size_t bus, EEPROMShadow &shadow)
+{
+    if (bus >= buses_.size())
+    {
+        return false;
+    }
+
+    buses_[bus].push_back(&shadow);
+    return true;
+}
+
+/**
+ * @brief Загрузить все зеркала.
+ */
+void EEPROMStartupLoader::run()
+{
+    // Результаты раскладываются заранее: каждый поток пишет только свои элементы
+    results_.clear();
+    std::vector<std::size_t> first_result(buses_.size());
+    for (std::size_t bus = 0; bus < buses_.size(); ++bus)
+    {
+        first_result[bus] = results_.size();
+        for (std::size_t chip = 0; chip < buses_[bus].size(); ++chip)
+        {
+            results_.push_back({bus, chip, 0, 0});
+        }
+    }
+
+    const Clock::time_point started = Clock::now();
+
+    auto loadBus = [&](std::size_t bus) {
+        for (std::size_t chip = 0; chip < buses_[bus].size(); ++chip)
+        {
+            const Clock::time_point begin = Clock::now();
+            buses_[bus][chip]->load();
+            const Clock::time_point end = Clock::now();
+
+            ChipResult &result = results_[first_result[bus] + chip];
+            result.startUs = microsecondsBetween(started, begin);
+            result.loadTimeUs = microsecondsBetween(begin, end);
+        }
+    };
+
+    // Последняя шина загружается в вызывающем потоке; если emplace_back()
+    // бросит исключение, guard дождётся уже запущенных потоков
+    std::vector<std::thread> threads;
+    {
+        JoinGuard guard(threads);
+        if (!buses_.empty())
+        {
+            threads.reserve(buses_.size() - 1);
+            for (std::size_t bus = 0; bus + 1 < buses_.size(); ++bus)
+            {
+                threads.emplace_back(loadBus, bus);
+            }
+            loadBus(buses_.size() - 1);
+        }
+    }
+
+    totalTimeUs_ = microsecondsBetween(started, Clock::now());
+}
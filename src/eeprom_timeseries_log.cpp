@@ -0,0 +1,593 @@
+#include "eeprom_timeseries_log.hpp"
+#include "eeprom_bitstream.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    uint32_t zigzag(uint32_t value)
+    {
+        const int32_t s = static_cast<int32_t>(value);
+        return (static_cast<uint32_t>(s) << 1) ^ static_cast<uint32_t>(s >> 31);
+    }
+
+    uint32_t unzigzag(uint32_t value)
+    {
+        return (value >> 1) ^ (0u - (value & 1u));
+    }
+
+    /**
+     * @brief Корзина кода: префикс из prefixBits единиц (кроме последней
+     *        корзины - с завершающим нулём) и поле payloadBits бит.
+     */
+    struct Bucket
+    {
+        uint32_t limit;       ///< Верхняя граница zigzag-значения (не включительно)
+        unsigned payloadBits; ///< Размер поля
+    };
+
+    // Корзины времени: '0', '10', '110', '1110', '1111'
+    constexpr Bucket TIME_BUCKETS[] = {{1, 0}, {128, 7}, {512, 9}, {4096, 12}, {0, 32}};
+
+    // Корзины значения: '0', '10', '110', '111'
+    constexpr Bucket VALUE_BUCKETS[] = {{1, 0}, {8, 3}, {128, 7}, {0, 16}};
+
+    template <std::size_t N>
+    std::size_t bucketOf(const Bucket (&buckets)[N], uint32_t zigzagged)
+    {
+        for (std::size_t i = 0; i + 1 < N; ++i)
+        {
+            if (zigzagged < buckets[i].limit)
+            {
+                return i;
+            }
+        }
+        return N - 1;
+    }
+
+    template <std::size_t N>
+    unsigned codeBits(const Bucket (&buckets)[N], std::size_t bucket)
+    {
+        // Префикс: bucket единиц и ноль, у последней корзины без нуля
+        const unsigned prefix = static_cast<unsigned>(bucket + (bucket + 1 < N ? 1 : 0));
+        return prefix + buckets[bucket].payloadBits;
+    }
+
+    template <std::size_t N>
+    void writeCode(BitStreamWriter &writer, const Bucket (&buckets)[N], uint32_t zigzagged)
+    {
+        const std::size_t bucket = bucketOf(buckets, zigzagged);
+        for (std::size_t i = 0; i < bucket; ++i)
+        {
+            writer.write(1, 1);
+        }
+        if (bucket + 1 < N)
+        {
+            writer.write(0, 1);
+        }
+        writer.write(zigzagged, buckets[bucket].payloadBits);
+    }
+
+    template <std::size_t N>
+    bool readCode(BitStreamReader &reader, const Bucket (&buckets)[N], uint32_t &zigzagged)
+    {
+        std::size_t bucket = 0;
+        uint32_t bit = 1;
+        while (bucket + 1 < N)
+        {
+            if (!reader.read(bit, 1))
+            {
+                return false;
+            }
+            if (bit == 0)
+            {
+                break;
+            }
+            ++bucket;
+        }
+        return reader.read(zigzagged, buckets[bucket].payloadBits);
+    }
+
+    uint16_t loadLe16(const uint8_t *data)
+    {
+        return static_cast<uint16_t>(data[0] | (data[1] << 8));
+    }
+
+    void storeLe16(uint8_t *data, uint16_t value)
+    {
+        data[0] = static_cast<uint8_t>(value & 0xFF);
+        data[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    uint32_t loadLe32(const uint8_t *data)
+    {
+        return static_cast<uint32_t>(data[0]) |
+               (static_cast<uint32_t>(data[1]) << 8) |
+               (static_cast<uint32_t>(data[2]) << 16) |
+               (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    /**
+     * @brief Фильтр отсчётов по интервалу для query().
+     */
+    struct RangeFilter
+    {
+        uint32_t from;
+        uint32_t to;
+        EEPROMTimeSeriesLog::SampleCallback callback;
+        void *context;
+        std::size_t count;
+
+        static void onSample(const EEPROMTimeSeriesLog::Sample &sample, void *context)
+        {
+            RangeFilter &filter = *static_cast<RangeFilter *>(context);
+            if (sample.timestamp >= filter.from && sample.timestamp <= filter.to)
+            {
+                ++filter.count;
+                if (filter.callback != nullptr)
+                {
+                    filter.callback(sample, filter.context);
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Сводка по отсчётам интервала для summarize() и индекса.
+     */
+    struct SummaryCollector
+    {
+        uint32_t from;
+        uint32_t to;
+        EEPROMTimeSeriesLog::Summary summary;
+
+        static void onSample(const EEPROMTimeSeriesLog::Sample &sample, void *context)
+        {
+            SummaryCollector &collector = *static_cast<SummaryCollector *>(context);
+            if (sample.timestamp >= collector.from && sample.timestamp <= collector.to)
+            {
+                EEPROMTimeSeriesLog::Summary &summary = collector.summary;
+                ++summary.count;
+                summary.min = std::min(summary.min, sample.value);
+                summary.max = std::max(summary.max, sample.value);
+            }
+        }
+    };
+}
+
+EEPROMTimeSeriesLog::EEPROMTimeSeriesLog(EEPROM25LC040A &eeprom,
+                                         std::size_t firstPage,
+                                         std::size_t pageCount)
+    : eeprom_(eeprom),
+      firstPage_(firstPage),
+      pageCount_(pageCount),
+      block_{},
+      state_{},
+      head_(0),
+      sequence_(0),
+      hasBlock_(false),
+      dirty_(false),
+      blockStart_{},
+      summaries_{},
+      indexed_(0),
+      lastQueryPages_(0)
+{
+    // Кольцо должно помещаться в микросхему
+    const std::size_t total_pages = EEPROM25LC040A::CAPACITY_BYTES / PAGE;
+    if (firstPage_ >= total_pages || pageCount_ > total_pages - firstPage_)
+    {
+        pageCount_ = 0;
+    }
+}
+
+/**
+ * @brief Найти последний блок на микросхеме и продолжить журнал с него.
+ */
+void EEPROMTimeSeriesLog::open()
+{
+    hasBlock_ = false;
+    dirty_ = false;
+    head_ = 0;
+    sequence_ = 0;
+    indexed_ = 0;
+
+    if (pageCount_ == 0)
+    {
+        return;
+    }
+
+    // Вся область журнала одним кадром READ
+    uint8_t blocks[MAX_PAGES][PAGE];
+    eeprom_.readArray(pageAddress(0), blocks[0], pageCount_ * PAGE);
+
+    // Последний блок - тот, за которым не следует блок с номером на единицу больше
+    for (std::size_t i = 0; i < pageCount_; ++i)
+    {
+        if (!isValidHeader(blocks[i]))
+        {
+            continue;
+        }
+
+        const std::size_t next = (i + 1) % pageCount_;
+        const bool continued = next != i && isValidHeader(blocks[next]) &&
+                               blocks[next][0] == static_cast<uint8_t>(blocks[i][0] + 1);
+        if (continued || decodeBlock(blocks[i], nullptr, nullptr, &state_) == 0)
+        {
+            continue;
+        }
+
+        std::memcpy(block_, blocks[i], PAGE);
+        head_ = i;
+        sequence_ = block_[0];
+        hasBlock_ = true;
+        break;
+    }
+
+    if (!hasBlock_)
+    {
+        return;
+    }
+
+    // Индекс: блоки с последовательными номерами, от последнего назад
+    for (std::size_t k = 0; k < pageCount_; ++k)
+    {
+        const std::size_t index = (head_ + pageCount_ - k) % pageCount_;
+        const uint8_t *block = blocks[index];
+        if (!isValidHeader(block) || block[0] != static_cast<uint8_t>(sequence_ - k))
+        {
+            break;
+        }
+
+        indexBlock(index, block);
+    }
+}
+
+/**
+ * @brief Добавить отсчёт.
+ */
+bool EEPROMTimeSeriesLog::append(uint32_t timestamp, int16_t value)
+{
+    if (pageCount_ == 0)
+    {
+        return false;
+    }
+
+    if (!hasBlock_)
+    {
+        startBlock(timestamp, value);
+        return true;
+    }
+
+    const uint32_t delta = timestamp - state_.timestamp;
+    const uint32_t time_code = zigzag(delta - state_.delta);
+    const uint16_t raw_value = static_cast<uint16_t>(value);
+    const uint32_t value_code =
+        zigzag(static_cast<uint32_t>(static_cast<int16_t>(raw_value - state_.value))) & 0xFFFFu;
+
+    const std::size_t bits = codeBits(TIME_BUCKETS, bucketOf(TIME_BUCKETS, time_code)) +
+                             codeBits(VALUE_BUCKETS, bucketOf(VALUE_BUCKETS, value_code));
+
+    if (bits > PAYLOAD_BITS - state_.bits || block_[1] == MAX_BLOCK_SAMPLES)
+    {
+        // Блок заполнен: записываем и начинаем следующий
+        flush();
+        head_ = (head_ + 1) % pageCount_;
+        ++sequence_;
+        startBlock(timestamp, value);
+        return true;
+    }
+
+    BitStreamWriter writer(block_ + HEADER_SIZE, PAYLOAD_BITS, state_.bits);
+    writeCode(writer, TIME_BUCKETS, time_code);
+    writeCode(writer, VALUE_BUCKETS, value_code);
+
+    state_.timestamp = timestamp;
+    state_.delta = delta;
+    state_.value = raw_value;
+    state_.bits = writer.position();
+    ++block_[1];
+
+    // Сводка текущего блока - по добавленному значению, без декодирования
+    BlockSummary &summary = summaries_[head_];
+    summary.min = std::min(summary.min, value);
+    summary.max = std::max(summary.max, value);
+    summary.count = block_[1];
+    dirty_ = true;
+    return true;
+}
+
+/**
+ * @brief Записать текущий блок на микросхему.
+ */
+bool EEPROMTimeSeriesLog::flush()
+{
+    if (!dirty_)
+    {
+        return false;
+    }
+
+    eeprom_.writeArray(pageAddress(head_), block_, PAGE);
+    dirty_ = false;
+    return true;
+}
+
+/**
+ * @brief Перебрать все отсчёты от старых к новым.
+ */
+std::size_t EEPROMTimeSeriesLog::forEach(SampleCallback callback, void *context) const
+{
+    std::size_t count = 0;
+
+    for (std::size_t k = 1; k <= pageCount_ && hasBlock_; ++k)
+    {
+        const std::size_t index = (head_ + k) % pageCount_;
+        if (indexed_ & (1u << index))
+        {
+            uint8_t block[PAGE];
+            readBlock(index, block);
+            count += decodeBlock(block, callback, context, nullptr);
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Перебрать отсчёты с временем в интервале [from, to].
+ */
+std::size_t EEPROMTimeSeriesLog::query(uint32_t from,
+                                       uint32_t to,
+                                       SampleCallback callback,
+                                       void *context) const
+{
+    lastQueryPages_ = 0;
+    RangeFilter filter{from, to, callback, context, 0};
+
+    for (std::size_t k = 1; k <= pageCount_ && hasBlock_ && from <= to; ++k)
+    {
+        const std::size_t index = (head_ + k) % pageCount_;
+        if (!(indexed_ & (1u << index)))
+        {
+            continue;
+        }
+
+        // Блок начинается позже интервала - дальше только более поздние
+        if (blockStart_[index] > to)
+        {
+            break;
+        }
+
+        if (!overlaps(index, from, to))
+        {
+            continue;
+        }
+
+        uint8_t block[PAGE];
+        readBlock(index, block);
+        if (index != head_)
+        {
+            ++lastQueryPages_;
+        }
+        decodeBlock(block, RangeFilter::onSample, &filter, nullptr);
+    }
+
+    return filter.count;
+}
+
+/**
+ * @brief Количество, минимум и максимум значений в интервале [from, to].
+ */
+EEPROMTimeSeriesLog::Summary EEPROMTimeSeriesLog::summarize(uint32_t from, uint32_t to) const
+{
+    lastQueryPages_ = 0;
+    Summary summary{0, INT16_MAX, INT16_MIN};
+    if (!hasBlock_ || from > to)
+    {
+        return summary;
+    }
+
+    auto merge = [&summary](std::size_t count, int min, int max) {
+        summary.count += count;
+        summary.min = static_cast<int16_t>(std::min<int>(summary.min, min));
+        summary.max = static_cast<int16_t>(std::max<int>(summary.max, max));
+    };
+
+    for (std::size_t k = 1; k <= pageCount_; ++k)
+    {
+        const std::size_t index = (head_ + k) % pageCount_;
+        if (!(indexed_ & (1u << index)) || !overlaps(index, from, to))
+        {
+            continue;
+        }
+
+        // Блок целиком в интервале - по индексу, без чтения
+        if (coveredBy(index, from, to))
+        {
+            const BlockSummary &block = summaries_[index];
+            merge(block.count, block.min, block.max);
+            continue;
+        }
+
+        // Граничный блок декодируется
+        uint8_t block[PAGE];
+        readBlock(index, block);
+        if (index != head_)
+        {
+            ++lastQueryPages_;
+        }
+
+        SummaryCollector collector{from, to, {0, INT16_MAX, INT16_MIN}};
+        decodeBlock(block, SummaryCollector::onSample, &collector, nullptr);
+        if (collector.summary.count > 0)
+        {
+            merge(collector.summary.count, collector.summary.min, collector.summary.max);
+        }
+    }
+
+    return summary;
+}
+
+/**
+ * @brief Блок целиком лежит в интервале [from, to].
+ */
+bool EEPROMTimeSeriesLog::coveredBy(std::size_t index, uint32_t from, uint32_t to) const
+{
+    // Последний отсчёт блока не позже первого отсчёта следующего;
+    // конец текущего блока - время последнего добавленного отсчёта
+    const std::size_t next = (index + 1) % pageCount_;
+    uint32_t end = 0;
+    if (index == head_)
+    {
+        end = state_.timestamp;
+    }
+    else if (indexed_ & (1u << next))
+    {
+        end = blockStart_[next];
+    }
+    else
+    {
+        return false;
+    }
+
+    return blockStart_[index] >= from && end <= to;
+}
+
+/**
+ * @brief Блок может содержать отсчёты из интервала [from, to].
+ */
+bool EEPROMTimeSeriesLog::overlaps(std::size_t index, uint32_t from, uint32_t to) const
+{
+    if (blockStart_[index] > to)
+    {
+        return false;
+    }
+
+    // Блок заканчивается не позже начала следующего
+    const std::size_t next = (index + 1) % pageCount_;
+    if (index == head_)
+    {
+        return state_.timestamp >= from;
+    }
+    return !((indexed_ & (1u << next)) && blockStart_[next] < from);
+}
+
+/**
+ * @brief Корректен ли заголовок блока.
+ */
+bool EEPROMTimeSeriesLog::isValidHeader(const uint8_t *block)
+{
+    // Стёртая страница (0xFF) и обнулённая не проходят по количеству отсчётов
+    return block[1] >= 1 && block[1] <= MAX_BLOCK_SAMPLES;
+}
+
+/**
+ * @brief Декодировать блок.
+ */
+std::size_t EEPROMTimeSeriesLog::decodeBlock(const uint8_t *block,
+                                             SampleCallback callback,
+                                             void *context,
+                                             CodecState *state)
+{
+    if (!isValidHeader(block))
+    {
+        return 0;
+    }
+
+    CodecState current{};
+    current.timestamp = loadLe32(block + 2);
+    current.value = loadLe16(block + 6);
+
+    if (callback != nullptr)
+    {
+        callback({current.timestamp, static_cast<int16_t>(current.value)}, context);
+    }
+
+    BitStreamReader reader(block + HEADER_SIZE, PAYLOAD_BITS);
+    const std::size_t count = block[1];
+    for (std::size_t i = 1; i < count; ++i)
+    {
+        uint32_t time_code = 0;
+        uint32_t value_code = 0;
+        if (!readCode(reader, TIME_BUCKETS, time_code) ||
+            !readCode(reader, VALUE_BUCKETS, value_code))
+        {
+            return i;
+        }
+
+        current.delta += unzigzag(time_code);
+        current.timestamp += current.delta;
+        current.value = static_cast<uint16_t>(current.value + unzigzag(value_code));
+
+        if (callback != nullptr)
+        {
+            callback({current.timestamp, static_cast<int16_t>(current.value)}, context);
+        }
+    }
+
+    current.bits = reader.position();
+    if (state != nullptr)
+    {
+        *state = current;
+    }
+    return count;
+}
+
+/**
+ * @brief Прочитать блок кольца.
+ */
+void EEPROMTimeSeriesLog::readBlock(std::size_t index, uint8_t *block) const
+{
+    if (index == head_)
+    {
+        std::memcpy(block, block_, PAGE);
+    }
+    else
+    {
+        eeprom_.readArray(pageAddress(index), block, PAGE);
+    }
+}
+
+/**
+ * @brief Занести блок в индекс: время по заголовку, сводку декодированием.
+ */
+void EEPROMTimeSeriesLog::indexBlock(std::size_t index, const uint8_t *block)
+{
+    SummaryCollector collector{0, UINT32_MAX, {0, INT16_MAX, INT16_MIN}};
+    decodeBlock(block, SummaryCollector::onSample, &collector, nullptr);
+
+    blockStart_[index] = loadLe32(block + 2);
+    summaries_[index] = BlockSummary{collector.summary.min,
+                                     collector.summary.max,
+                                     static_cast<uint8_t>(collector.summary.count)};
+    indexed_ |= 1u << index;
+}
+
+/**
+ * @brief Начать новый блок с отсчёта.
+ */
+void EEPROMTimeSeriesLog::startBlock(uint32_t timestamp, int16_t value)
+{
+    const uint16_t raw_value = static_cast<uint16_t>(value);
+
+    std::memset(block_, 0, sizeof(block_));
+    block_[0] = sequence_;
+    block_[1] = 1;
+    block_[2] = static_cast<uint8_t>(timestamp & 0xFF);
+    block_[3] = static_cast<uint8_t>((timestamp >> 8) & 0xFF);
+    block_[4] = static_cast<uint8_t>((timestamp >> 16) & 0xFF);
+    block_[5] = static_cast<uint8_t>(timestamp >> 24);
+    storeLe16(block_ + 6, raw_value);
+
+    state_ = CodecState{timestamp, 0, raw_value, 0};
+    indexBlock(head_, block_);
+    hasBlock_ = true;
+    dirty_ = true;
+}
+
+/**
+ * @brief Адрес страницы кольца.
+ */
+std::size_t EEPROMTimeSeriesLog::pageAddress(std::size_t index) const
+{
+    return (firstPage_ + index) * PAGE;
+}
@@ -0,0 +1,192 @@
+#include "eeprom_trace.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr uint8_t TRACE_MAGIC[] = {'E', 'T', 'R', '1'};
+    constexpr uint8_t OP_MASK = 0x1F;
+    constexpr unsigned BIT_OFFSET_SHIFT = 5;
+
+    // Самая длинная запись: байт операции и три LEB128-числа
+    constexpr std::size_t MAX_RECORD_SIZE = 1 + 3 * 10;
+
+    std::size_t writeVarint(uint8_t *out, uint64_t value)
+    {
+        std::size_t n = 0;
+        do
+        {
+            uint8_t byte = static_cast<uint8_t>(value & 0x7F);
+            value >>= 7;
+            out[n++] = static_cast<uint8_t>(byte | (value != 0 ? 0x80 : 0));
+        } while (value != 0);
+        return n;
+    }
+}
+
+EEPROMTraceRecorder::EEPROMTraceRecorder(uint8_t *buffer,
+                                         std::size_t capacity,
+                                         EEPROMClockFunction clock)
+    : buffer_(buffer),
+      capacity_(capacity),
+      size_(0),
+      overflowed_(false),
+      clock_(clock),
+      lastTimestamp_(0)
+{
+    clear();
+}
+
+void EEPROMTraceRecorder::clear()
+{
+    size_ = 0;
+    overflowed_ = false;
+    lastTimestamp_ = clock_ != nullptr ? clock_() : 0;
+
+    if (buffer_ != nullptr && capacity_ >= sizeof(TRACE_MAGIC))
+    {
+        std::memcpy(buffer_, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        size_ = sizeof(TRACE_MAGIC);
+    }
+    else
+    {
+        overflowed_ = true;
+    }
+}
+
+void EEPROMTraceRecorder::onOperationBegin(const EEPROMOperationInfo &info)
+{
+    if (overflowed_)
+    {
+        return;
+    }
+
+    // Приращение времени - 32-битная разность, переполнение часов не мешает
+    const uint32_t now = clock_ != nullptr ? clock_() : 0;
+    const uint32_t delta = now - lastTimestamp_;
+
+    uint8_t record[MAX_RECORD_SIZE];
+    std::size_t n = 0;
+    record[n++] = static_cast<uint8_t>((static_cast<uint8_t>(info.op) & OP_MASK) |
+                                       ((info.bitOffset & 0x07u) << BIT_OFFSET_SHIFT));
+    n += writeVarint(record + n, info.address);
+    n += writeVarint(record + n, info.length);
+    n += writeVarint(record + n, delta);
+
+    if (size_ + n > capacity_)
+    {
+        overflowed_ = true;
+        return;
+    }
+
+    std::memcpy(buffer_ + size_, record, n);
+    size_ += n;
+    lastTimestamp_ = now;
+}
+
+EEPROMTraceReader::EEPROMTraceReader(const uint8_t *data, std::size_t size)
+    : data_(data),
+      size_(size),
+      position_(0),
+      valid_(data != nullptr && size >= sizeof(TRACE_MAGIC) &&
+             std::memcmp(data, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0),
+      timestampUs_(0)
+{
+    rewind();
+}
+
+void EEPROMTraceReader::rewind()
+{
+    position_ = sizeof(TRACE_MAGIC);
+    timestampUs_ = 0;
+}
+
+bool EEPROMTraceReader::next(EEPROMTraceRecord &record)
+{
+    if (!valid_ || position_ >= size_)
+    {
+        return false;
+    }
+
+    const uint8_t op = data_[position_++];
+    uint64_t address = 0;
+    uint64_t length = 0;
+    uint64_t delta = 0;
+    if (!readVarint(address) || !readVarint(length) || !readVarint(delta))
+    {
+        valid_ = false;
+        return false;
+    }
+
+    timestampUs_ += delta;
+    record.info.op = static_cast<EEPROMOperation>(op & OP_MASK);
+    record.info.bitOffset = op >> BIT_OFFSET_SHIFT;
+    record.info.address = static_cast<std::size_t>(address);
+    record.info.length = static_cast<std::size_t>(length);
+    record.timestampUs = timestampUs_;
+    return true;
+}
+
+bool EEPROMTraceReader::readVarint(uint64_t &value)
+{
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        if (position_ >= size_)
+        {
+            return false;
+        }
+
+        const uint8_t byte = data_[position_++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t replayTrace(EEPROMTraceReader &reader, EEPROM25LC040A &eeprom)
+{
+    uint8_t buffer[EEPROM25LC040A::CAPACITY_BYTES];
+    std::size_t replayed = 0;
+    EEPROMTraceRecord record{};
+
+    while (reader.next(record))
+    {
+        const EEPROMOperationInfo &info = record.info;
+        const std::size_t length = std::min(info.length, sizeof(buffer));
+
+        switch (info.op)
+        {
+        case EEPROMOperation::READ_BYTE:
+            eeprom.readByte(info.address);
+            break;
+        case EEPROMOperation::WRITE_BYTE:
+            eeprom.writeByte(info.address, 0);
+            break;
+        case EEPROMOperation::READ_ARRAY:
+        case EEPROMOperation::READ_FIELDS:
+            eeprom.readArray(info.address, buffer, length);
+            break;
+        case EEPROMOperation::WRITE_ARRAY:
+        case EEPROMOperation::WRITE_FIELDS:
+            std::fill(buffer, buffer + length, 0);
+            eeprom.writeArray(info.address, buffer, length);
+            break;
+        case EEPROMOperation::READ_BITS:
+            eeprom.readBits(info.address, info.bitOffset, static_cast<unsigned>(info.length));
+            break;
+        case EEPROMOperation::WRITE_BITS:
+            eeprom.writeBits(info.address, info.bitOffset, static_cast<unsigned>(info.length), 0);
+            break;
+        default:
+            continue; // Неизвестная операция
+        }
+
+        ++replayed;
+    }
+
+    return replayed;
+}
@@ -0,0 +1,137 @@
+#include "eeprom_test.hpp"
+#include <cstring>
+
+/**
+ * @file eeprom_broadcast_test.cpp
+ * @brief Тест широковещательной записи EEPROM25LC040A::broadcastWriteArray().
+ */
+
+namespace
+{
+    constexpr std::size_t CHIPS = 3;
+
+    /**
+     * @brief Микросхемы на общих SCLK и MOSI с отдельными CS.
+     */
+    struct SharedBusChips
+    {
+        EEPROM25LC040ASimulator simulators[CHIPS];
+        EEPROM25LC040ASimulator *pointers[CHIPS];
+        EEPROM25LC040ASharedBus bus;
+        SPIBitBangingHelper spi[CHIPS];
+        EEPROM25LC040A eeproms[CHIPS];
+        EEPROM25LC040A *chips[CHIPS];
+
+        SharedBusChips()
+            : simulators(),
+              pointers{&simulators[0], &simulators[1], &simulators[2]},
+              bus(pointers, CHIPS),
+              spi{SPIBitBangingHelper(bus.port(0)), SPIBitBangingHelper(bus.port(1)), SPIBitBangingHelper(bus.port(2))},
+              eeproms{EEPROM25LC040A(spi[0]), EEPROM25LC040A(spi[1]), EEPROM25LC040A(spi[2])},
+              chips{&eeproms[0], &eeproms[1], &eeproms[2]}
+        {
+        }
+    };
+
+    /**
+     * @brief Наблюдатель, запоминающий операции.
+     */
+    struct CountingListener : EEPROMOperationListener
+    {
+        unsigned begins = 0;
+        unsigned ends = 0;
+        EEPROMOperationInfo last{};
+
+        void onOperationBegin(const EEPROMOperationInfo &) override { ++begins; }
+
+        void onOperationEnd(const EEPROMOperationInfo &info) override
+        {
+            ++ends;
+            last = info;
+        }
+    };
+
+    bool checkEveryChipProgrammed()
+    {
+        SharedBusChips chips;
+        uint8_t data[100];
+        fillPattern(data, sizeof(data), 1);
+
+        EEPROM25LC040A::broadcastWriteArray(chips.chips, CHIPS, 10, data, sizeof(data));
+
+        // Адреса 10..109 - страницы 0..6
+        for (const EEPROM25LC040ASimulator &simulator : chips.simulators)
+        {
+            if (std::memcmp(simulator.memory() + 10, data, sizeof(data)) != 0 ||
+                simulator.statistics().writeCycles != 7)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool checkListenersAndCounters()
+    {
+        SharedBusChips chips;
+        CountingListener listeners[CHIPS];
+        for (std::size_t c = 0; c < CHIPS; ++c)
+        {
+            chips.eeproms[c].addListener(&listeners[c]);
+        }
+
+        uint8_t data[40];
+        fillPattern(data, sizeof(data), 2);
+        EEPROM25LC040A::broadcastWriteArray(chips.chips, CHIPS, 16, data, sizeof(data));
+
+        const EEPROM25LC040A::BusStatistics &first = chips.eeproms[0].busStatistics();
+        for (std::size_t c = 0; c < CHIPS; ++c)
+        {
+            const CountingListener &listener = listeners[c];
+            const EEPROM25LC040A::BusStatistics &bus = chips.eeproms[c].busStatistics();
+            if (listener.begins != 1 || listener.ends != 1 ||
+                listener.last.op != EEPROMOperation::WRITE_ARRAY ||
+                listener.last.address != 16 || listener.last.length != sizeof(data) ||
+                bus.writeCycles != 3 || bus.statusPolls == 0)
+            {
+                return false;
+            }
+
+            // Общие кадры (WREN + WRITE на страницу) учтены у каждой микросхемы
+            if (bus.bytes - 2 * bus.statusPolls != first.bytes - 2 * first.statusPolls)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool checkTimeDoesNotGrowWithChips()
+    {
+        uint8_t image[EEPROM25LC040A::CAPACITY_BYTES];
+        fillPattern(image, sizeof(image), 3);
+
+        TestChip single;
+        single.eeprom.writeArray(0, image, sizeof(image));
+
+        SharedBusChips chips;
+        EEPROM25LC040A::broadcastWriteArray(chips.chips, CHIPS, 0, image, sizeof(image));
+
+        // Лишь несколько дополнительных чтений статуса на страницу
+        const uint64_t one = single.simulator.elapsedNs();
+        const uint64_t many = chips.simulators[0].elapsedNs();
+        return many < one + one / 10 &&
+               std::memcmp(chips.simulators[CHIPS - 1].memory(), image, sizeof(image)) == 0;
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"every_chip_programmed", checkEveryChipProgrammed},
+        {"listeners_and_counters", checkListenersAndCounters},
+        {"time_does_not_grow", checkTimeDoesNotGrowWithChips},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
@@ -0,0 +1,120 @@
+#include "eeprom_test.hpp"
+#include "eeprom_cache_model.hpp"
+
+/**
+ * @file eeprom_cache_model_test.cpp
+ * @brief Тест модели кеша EEPROMCacheModel на известных трассах.
+ */
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+
+    // Отложенный сброс, не наступающий за время трассы
+    constexpr uint32_t WRITE_BACK = 1000000000u;
+
+    /**
+     * @brief Трасса, собранная из списка операций (время не записывается).
+     */
+    struct Trace
+    {
+        uint8_t data[256];
+        std::size_t size;
+
+        template <std::size_t N>
+        explicit Trace(const EEPROMOperationInfo (&operations)[N]) : data{}, size(0)
+        {
+            EEPROMTraceRecorder recorder(data, sizeof(data), nullptr);
+            for (const EEPROMOperationInfo &info : operations)
+            {
+                recorder.onOperationBegin(info);
+            }
+            size = recorder.size();
+        }
+    };
+
+    EEPROMCacheReport simulate(const Trace &trace, EEPROMCacheConfig::Policy policy,
+                               uint32_t flushIntervalUs)
+    {
+        const EEPROMCacheConfig config{policy, 4, 0, flushIntervalUs, 1000, 5000};
+        EEPROMCacheModel model(config);
+        EEPROMTraceReader reader(trace.data, trace.size);
+        return model.run(reader);
+    }
+
+    // Четыре чтения одной страницы
+    const EEPROMOperationInfo REPEATED_READS[] = {
+        {EEPROMOperation::READ_ARRAY, 0, PAGE, 0},
+        {EEPROMOperation::READ_ARRAY, 0, PAGE, 0},
+        {EEPROMOperation::READ_ARRAY, 0, PAGE, 0},
+        {EEPROMOperation::READ_ARRAY, 0, PAGE, 0},
+    };
+
+    // Две записи в одну страницу с промежутком между ними
+    const EEPROMOperationInfo GAPPED_WRITES[] = {
+        {EEPROMOperation::WRITE_BYTE, 0, 1, 0},
+        {EEPROMOperation::WRITE_BYTE, 5, 1, 0},
+    };
+
+    // Две записи в одну страницу подряд
+    const EEPROMOperationInfo ADJACENT_WRITES[] = {
+        {EEPROMOperation::WRITE_ARRAY, 0, 3, 0},
+        {EEPROMOperation::WRITE_ARRAY, 3, 3, 0},
+    };
+
+    bool checkRepeatedReads()
+    {
+        const Trace trace(REPEATED_READS);
+        const EEPROMCacheReport none = simulate(trace, EEPROMCacheConfig::Policy::NONE, 0);
+        const EEPROMCacheReport lru = simulate(trace, EEPROMCacheConfig::Policy::LRU, 0);
+        const EEPROMCacheReport mirror = simulate(trace, EEPROMCacheConfig::Policy::FULL_MIRROR, 0);
+
+        // Кадр чтения - команда, два байта адреса и данные
+        return none.operations == 4 && none.busTransactions == 4 && none.busBytes == 4 * (3 + PAGE) &&
+               lru.busTransactions == 1 && lru.busBytes == 3 + PAGE &&
+               lru.cacheMisses == 1 && lru.cacheHits == 3 &&
+               mirror.busTransactions == 1 && mirror.busBytes == 3 + CAPACITY &&
+               mirror.cacheMisses == CAPACITY / PAGE && mirror.cacheHits == 4 &&
+               none.foregroundUs > lru.foregroundUs && mirror.foregroundUs == 0;
+    }
+
+    bool checkGappedWriteFetchesPage()
+    {
+        const Trace trace(GAPPED_WRITES);
+        const EEPROMCacheReport none = simulate(trace, EEPROMCacheConfig::Policy::NONE, 0);
+        const EEPROMCacheReport through = simulate(trace, EEPROMCacheConfig::Policy::LRU, 0);
+        const EEPROMCacheReport back = simulate(trace, EEPROMCacheConfig::Policy::LRU, WRITE_BACK);
+
+        // Отложенный сброс пишет байты 0..5 одним циклом, но байты 1..4 нужно
+        // сначала прочитать: кадр чтения страницы и кадр WREN + WRITE
+        return none.writeCycles == 2 && none.busTransactions == 2 &&
+               through.writeCycles == 2 && through.cacheMisses == 0 &&
+               back.writeCycles == 1 && back.busTransactions == 2 && back.cacheMisses == 1 &&
+               back.busBytes == (3 + PAGE) + (1 + 3 + 6) && back.foregroundUs == 0;
+    }
+
+    bool checkAdjacentWritesNeedNoFetch()
+    {
+        const Trace trace(ADJACENT_WRITES);
+        const EEPROMCacheReport back = simulate(trace, EEPROMCacheConfig::Policy::LRU, WRITE_BACK);
+        const EEPROMCacheReport mirror = simulate(trace, EEPROMCacheConfig::Policy::FULL_MIRROR, WRITE_BACK);
+
+        // Зеркало уже содержит страницу: после загрузки только одна запись
+        return back.writeCycles == 1 && back.busTransactions == 1 && back.cacheMisses == 0 &&
+               back.busBytes == 1 + 3 + 6 &&
+               mirror.writeCycles == 1 && mirror.busTransactions == 2 &&
+               mirror.cacheMisses == CAPACITY / PAGE;
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"repeated_reads", checkRepeatedReads},
+        {"gapped_write_fetches_page", checkGappedWriteFetchesPage},
+        {"adjacent_writes_no_fetch", checkAdjacentWritesNeedNoFetch},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
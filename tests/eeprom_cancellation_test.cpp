@@ -0,0 +1,161 @@
+#include "eeprom_test.hpp"
+#include <cstring>
+
+/**
+ * @file eeprom_cancellation_test.cpp
+ * @brief Тест отмены длительных операций и проверки verifyArray().
+ */
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+    constexpr std::size_t CHUNK = EEPROM25LC040A::CANCEL_CHUNK;
+
+    /**
+     * @brief Линии симулятора, запрашивающие отмену посреди операции.
+     *
+     * Отмена запрашивается по фронту CS, когда симулятор выполнил
+     * заданное количество циклов записи или кадров чтения.
+     */
+    class CancellingDriver : public SPIBitBangingDriver
+    {
+    public:
+        CancellingDriver(EEPROM25LC040ASimulator &simulator, CancellationToken &token)
+            : simulator_(simulator), token_(token), writeCycles_(0), frames_(0) {}
+
+        void cancelAfterWriteCycles(uint64_t cycles) { writeCycles_ = cycles; }
+        void cancelAfterFrames(uint64_t frames) { frames_ = frames; }
+
+        void cs_low() override { simulator_.cs_low(); }
+        void write_mosi(bool bit) override { simulator_.write_mosi(bit); }
+        bool read_miso() override { return simulator_.read_miso(); }
+        void pulse_clock() override { simulator_.pulse_clock(); }
+        void delay_us(unsigned us) override { simulator_.delay_us(us); }
+
+        void cs_high() override
+        {
+            simulator_.cs_high();
+
+            const EEPROM25LC040ASimulator::Statistics &stats = simulator_.statistics();
+            if ((writeCycles_ != 0 && stats.writeCycles >= writeCycles_) ||
+                (frames_ != 0 && stats.frames >= frames_))
+            {
+                token_.cancel();
+            }
+        }
+
+    private:
+        EEPROM25LC040ASimulator &simulator_;
+        CancellationToken &token_;
+        uint64_t writeCycles_;
+        uint64_t frames_;
+    };
+
+    /**
+     * @brief Микросхема, операции которой можно отменить изнутри.
+     */
+    struct CancellableChip
+    {
+        EEPROM25LC040ASimulator simulator;
+        CancellationToken token;
+        CancellingDriver driver;
+        SPIBitBangingHelper spi;
+        EEPROM25LC040A eeprom;
+
+        CancellableChip() : simulator(), token(), driver(simulator, token), spi(driver), eeprom(spi) {}
+    };
+
+    bool checkCancelledBeforeStart()
+    {
+        TestChip chip;
+        CancellationToken token;
+        token.cancel();
+
+        uint8_t buffer[CAPACITY];
+        const uint8_t data[4] = {1, 2, 3, 4};
+        const OperationProgress read = chip.eeprom.readArray(0, buffer, CAPACITY, token);
+        const OperationProgress written = chip.eeprom.writeArray(0, data, sizeof(data), token);
+        return read.cancelled && read.completed == 0 && read.total == CAPACITY &&
+               written.cancelled && written.completed == 0 &&
+               chip.simulator.statistics().writeCycles == 0;
+    }
+
+    bool checkWriteStopsOnPageBoundary()
+    {
+        CancellableChip chip;
+        chip.driver.cancelAfterWriteCycles(2);
+
+        // С адреса 10: неполная первая страница и вторая целиком
+        uint8_t data[100];
+        fillPattern(data, sizeof(data), 1);
+        const OperationProgress progress = chip.eeprom.writeArray(10, data, sizeof(data), chip.token);
+
+        const std::size_t written = 2 * PAGE - 10;
+        const uint8_t *memory = chip.simulator.memory();
+        return progress.cancelled && progress.completed == written && progress.total == sizeof(data) &&
+               std::memcmp(memory + 10, data, written) == 0 && memory[10 + written] == 0xFF &&
+               chip.simulator.statistics().writeCycles == 2;
+    }
+
+    bool checkReadStopsBetweenFrames()
+    {
+        CancellableChip chip;
+        fillPattern(chip.simulator.memory(), CAPACITY, 3);
+        chip.driver.cancelAfterFrames(1);
+
+        uint8_t buffer[CAPACITY];
+        std::memset(buffer, 0, sizeof(buffer));
+        const OperationProgress progress = chip.eeprom.readArray(0, buffer, CAPACITY, chip.token);
+        return progress.cancelled && progress.completed == CHUNK &&
+               std::memcmp(buffer, chip.simulator.memory(), CHUNK) == 0 && buffer[CHUNK] == 0;
+    }
+
+    bool checkVerifyStopsAtMismatch()
+    {
+        TestChip chip;
+        uint8_t data[CAPACITY];
+        fillPattern(data, CAPACITY, 7);
+        std::memcpy(chip.simulator.memory(), data, CAPACITY);
+
+        OperationProgress progress{};
+        if (!chip.eeprom.verifyArray(0, data, CAPACITY, nullptr, &progress) ||
+            progress.completed != CAPACITY)
+        {
+            return false;
+        }
+
+        // Расхождение в байте 100: чтение останавливается на втором кадре
+        chip.simulator.memory()[100] ^= 0xFF;
+        chip.eeprom.resetBusStatistics();
+        return !chip.eeprom.verifyArray(0, data, CAPACITY, nullptr, &progress) &&
+               progress.completed == 100 && !progress.cancelled &&
+               chip.eeprom.busStatistics().frames == 2;
+    }
+
+    bool checkVerifyCancelled()
+    {
+        TestChip chip;
+        uint8_t data[CAPACITY];
+        std::memset(data, 0xFF, sizeof(data));
+
+        CancellationToken token;
+        token.cancel();
+        OperationProgress progress{};
+        return !chip.eeprom.verifyArray(0, data, CAPACITY, &token, &progress) &&
+               progress.cancelled && progress.completed == 0;
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"cancelled_before_start", checkCancelledBeforeStart},
+        {"write_stops_on_page", checkWriteStopsOnPageBoundary},
+        {"read_stops_between_frames", checkReadStopsBetweenFrames},
+        {"verify_stops_at_mismatch", checkVerifyStopsAtMismatch},
+        {"verify_cancelled", checkVerifyCancelled},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
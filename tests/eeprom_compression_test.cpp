@@ -0,0 +1,161 @@
+#include "eeprom_test.hpp"
+#include "eeprom_compression.hpp"
+#include <cstring>
+
+/**
+ * @file eeprom_compression_test.cpp
+ * @brief Тест сжатия LZSS и сжатых записей EEPROM.
+ */
+
+namespace
+{
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+
+    /**
+     * @brief Плохо сжимаемые данные (линейный конгруэнтный генератор).
+     */
+    void fillNoise(uint8_t *data, std::size_t length, uint32_t seed)
+    {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+            data[i] = static_cast<uint8_t>(seed >> 16);
+        }
+    }
+
+    /**
+     * @brief Сжать и распаковать, подавая поток частями по chunk байт.
+     */
+    bool roundTrip(const uint8_t *data, std::size_t length, std::size_t chunk)
+    {
+        uint8_t packed[2 * CAPACITY];
+        const std::size_t size = lzCompress(data, length, packed, sizeof(packed));
+        if (size == 0)
+        {
+            return false;
+        }
+
+        uint8_t restored[CAPACITY];
+        LzDecoder decoder(restored, length);
+        for (std::size_t offset = 0; offset < size; offset += chunk)
+        {
+            const std::size_t part = size - offset < chunk ? size - offset : chunk;
+            if (!decoder.feed(packed + offset, part))
+            {
+                return false;
+            }
+        }
+
+        return decoder.done() && !decoder.failed() && std::memcmp(data, restored, length) == 0;
+    }
+
+    bool checkRoundTrip()
+    {
+        uint8_t data[CAPACITY];
+
+        // Нули: ссылки длиннее LZ_MAX_MATCH делятся на несколько
+        std::memset(data, 0, sizeof(data));
+        if (!roundTrip(data, sizeof(data), sizeof(data)) || !roundTrip(data, 1, 1))
+        {
+            return false;
+        }
+
+        fillPattern(data, sizeof(data), 3);
+        if (!roundTrip(data, sizeof(data), sizeof(data)))
+        {
+            return false;
+        }
+
+        fillNoise(data, sizeof(data), 1);
+        return roundTrip(data, sizeof(data), sizeof(data));
+    }
+
+    bool checkStreamingDecoder()
+    {
+        // Поток частями по байту и по кадру - тот же результат
+        uint8_t data[CAPACITY];
+        std::memset(data, 0, sizeof(data));
+        fillPattern(data, 64, 5);
+        fillNoise(data + 300, 40, 7);
+        return roundTrip(data, sizeof(data), 1) && roundTrip(data, sizeof(data), 7) &&
+               roundTrip(data, sizeof(data), EEPROM25LC040A::CANCEL_CHUNK);
+    }
+
+    bool checkDecoderRejectsBadReference()
+    {
+        // Первый элемент - ссылка на несуществующие данные
+        const uint8_t stream[] = {0x00, 0x04, 0x00};
+        uint8_t out[16];
+        LzDecoder decoder(out, sizeof(out));
+        return !decoder.feed(stream, sizeof(stream)) && decoder.failed();
+    }
+
+    bool checkCompressedRecord()
+    {
+        TestChip chip;
+        uint8_t data[256];
+        std::memset(data, 0, sizeof(data));
+        fillPattern(data, 32, 3);
+
+        const std::size_t stored = writeCompressedRecord(chip.eeprom, 16, data, sizeof(data), CAPACITY - 16);
+        uint8_t restored[256];
+        return stored > LZ_RECORD_HEADER && stored < sizeof(data) &&
+               readCompressedRecord(chip.eeprom, 16, restored, sizeof(restored)) == sizeof(data) &&
+               std::memcmp(data, restored, sizeof(data)) == 0;
+    }
+
+    bool checkIncompressibleStoredRaw()
+    {
+        TestChip chip;
+        uint8_t data[200];
+        fillNoise(data, sizeof(data), 11);
+
+        const std::size_t stored = writeCompressedRecord(chip.eeprom, 0, data, sizeof(data), CAPACITY);
+        uint8_t restored[200];
+        return stored == LZ_RECORD_HEADER + sizeof(data) &&
+               std::memcmp(chip.memory() + LZ_RECORD_HEADER, data, sizeof(data)) == 0 &&
+               readCompressedRecord(chip.eeprom, 0, restored, sizeof(restored)) == sizeof(data) &&
+               std::memcmp(data, restored, sizeof(data)) == 0;
+    }
+
+    bool checkRejectsBadRecords()
+    {
+        TestChip chip;
+        uint8_t data[200];
+        fillNoise(data, sizeof(data), 13);
+
+        // Не помещается в отведённое место - ничего не пишется
+        if (writeCompressedRecord(chip.eeprom, 0, data, sizeof(data), 100) != 0 ||
+            chip.simulator.statistics().writeCycles != 0)
+        {
+            return false;
+        }
+
+        uint8_t restored[200];
+        writeCompressedRecord(chip.eeprom, 0, data, sizeof(data), CAPACITY);
+
+        // Мал буфер результата
+        if (readCompressedRecord(chip.eeprom, 0, restored, sizeof(restored) - 1) != 0)
+        {
+            return false;
+        }
+
+        // Повреждён заголовок
+        chip.simulator.memory()[1] ^= 0x01;
+        return readCompressedRecord(chip.eeprom, 0, restored, sizeof(restored)) == 0;
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"round_trip", checkRoundTrip},
+        {"streaming_decoder", checkStreamingDecoder},
+        {"decoder_rejects_bad_ref", checkDecoderRejectsBadReference},
+        {"compressed_record", checkCompressedRecord},
+        {"incompressible_stored_raw", checkIncompressibleStoredRaw},
+        {"rejects_bad_records", checkRejectsBadRecords},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
@@ -0,0 +1,95 @@
+#include "eeprom_test.hpp"
+#include <cstring>
+
+/**
+ * @file eeprom_copy_test.cpp
+ * @brief Тест копирования диапазонов EEPROM25LC040A::copyBetween().
+ */
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+
+    bool checkBetweenChips()
+    {
+        TestChip a;
+        TestChip b;
+        fillPattern(a.simulator.memory(), CAPACITY, 1);
+
+        const OperationProgress copied = EEPROM25LC040A::copyBetween(a.eeprom, 0, b.eeprom, 0, CAPACITY);
+        return copied.completed == CAPACITY && !copied.cancelled &&
+               std::memcmp(a.memory(), b.memory(), CAPACITY) == 0 &&
+               b.simulator.statistics().writeCycles == CAPACITY / PAGE &&
+               a.simulator.statistics().writeCycles == 0;
+    }
+
+    bool checkUnalignedBetweenChips()
+    {
+        TestChip a;
+        TestChip b;
+        fillPattern(a.simulator.memory(), CAPACITY, 2);
+
+        // Куски выравниваются по страницам приёмника: 11 + 16 * 5 + 9 байт
+        const OperationProgress copied = EEPROM25LC040A::copyBetween(a.eeprom, 5, b.eeprom, 37, 100);
+        return copied.completed == 100 && std::memcmp(a.memory() + 5, b.memory() + 37, 100) == 0 &&
+               b.memory()[36] == 0xFF && b.memory()[137] == 0xFF &&
+               b.simulator.statistics().writeCycles == 7;
+    }
+
+    /**
+     * @brief Копирование внутри одной микросхемы сверяется с memmove.
+     */
+    bool checkSameChipOverlap(std::size_t source, std::size_t destination, std::size_t length)
+    {
+        TestChip chip;
+        fillPattern(chip.simulator.memory(), CAPACITY, 3);
+
+        uint8_t expected[CAPACITY];
+        std::memcpy(expected, chip.memory(), CAPACITY);
+        std::memmove(expected + destination, expected + source, length);
+
+        const OperationProgress copied =
+            EEPROM25LC040A::copyBetween(chip.eeprom, source, chip.eeprom, destination, length);
+        return copied.completed == length && !copied.cancelled &&
+               std::memcmp(chip.memory(), expected, CAPACITY) == 0;
+    }
+
+    bool checkSameChipOverlapDown()
+    {
+        return checkSameChipOverlap(40, 30, 100) && checkSameChipOverlap(PAGE, 0, 3 * PAGE);
+    }
+
+    bool checkSameChipOverlapUp()
+    {
+        return checkSameChipOverlap(30, 45, 100) && checkSameChipOverlap(0, PAGE, 3 * PAGE) &&
+               checkSameChipOverlap(100, 101, 200);
+    }
+
+    bool checkCancelled()
+    {
+        TestChip a;
+        TestChip b;
+        CancellationToken token;
+        token.cancel();
+
+        const OperationProgress between = EEPROM25LC040A::copyBetween(a.eeprom, 0, b.eeprom, 0, 64, &token);
+        const OperationProgress same = EEPROM25LC040A::copyBetween(a.eeprom, 0, a.eeprom, 8, 64, &token);
+        return between.cancelled && between.completed == 0 &&
+               same.cancelled && same.completed == 0 &&
+               a.simulator.statistics().writeCycles == 0 && b.simulator.statistics().writeCycles == 0;
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"between_chips", checkBetweenChips},
+        {"unaligned_between_chips", checkUnalignedBetweenChips},
+        {"same_chip_overlap_down", checkSameChipOverlapDown},
+        {"same_chip_overlap_up", checkSameChipOverlapUp},
+        {"cancelled", checkCancelled},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
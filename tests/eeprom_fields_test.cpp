@@ -0,0 +1,116 @@
+#include "eeprom_test.hpp"
+
+/**
+ * @file eeprom_fields_test.cpp
+ * @brief Тест битовых операций readBits()/writeBits() и readFields()/writeFields().
+ */
+
+namespace
+{
+    using BitField = EEPROM25LC040A::BitField;
+
+    bool checkBitsRoundTrip()
+    {
+        TestChip chip;
+        chip.eeprom.writeBits(200, 3, 10, 0x2AB);
+        chip.eeprom.writeBit(203, 7, true);
+
+        return chip.eeprom.readBits(200, 3, 10) == 0x2AB &&
+               chip.eeprom.readBit(203, 7) &&
+               (chip.memory()[200] & 0x07) == 0x07; // Соседние биты не тронуты
+    }
+
+    bool checkFieldsMatchReadBits()
+    {
+        TestChip chip;
+        uint8_t data[32];
+        fillPattern(data, sizeof(data), 11);
+        chip.eeprom.writeArray(64, data, sizeof(data));
+
+        const BitField fields[4] = {{64, 0, 12}, {65, 6, 9}, {70, 7, 32}, {90, 2, 1}};
+        uint32_t values[4] = {};
+        chip.eeprom.readFields(fields, 4, values);
+
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            if (values[i] != chip.eeprom.readBits(fields[i].address, fields[i].bitOffset, fields[i].bitCount))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool checkFieldsOneFrame()
+    {
+        TestChip chip;
+        const BitField fields[3] = {{300, 0, 12}, {301, 6, 9}, {310, 1, 5}};
+        const uint32_t written[3] = {0xABC, 0x155, 0x13};
+        chip.eeprom.writeFields(fields, 3, written);
+
+        chip.eeprom.resetBusStatistics();
+        uint32_t values[3] = {};
+        chip.eeprom.readFields(fields, 3, values);
+
+        return chip.eeprom.busStatistics().frames == 1 &&
+               values[0] == written[0] && values[1] == written[1] && values[2] == written[2];
+    }
+
+    bool checkOffsetPastFirstByte()
+    {
+        // Бит 20 от байта 100 - бит 4 байта 102
+        TestChip chip;
+        const BitField field{100, 20, 6};
+        const uint32_t value = 0x2D;
+        chip.eeprom.writeFields(&field, 1, &value);
+
+        uint32_t read = 0;
+        chip.eeprom.readFields(&field, 1, &read);
+        return read == value && chip.eeprom.readBits(102, 4, 6) == value &&
+               chip.memory()[100] == 0xFF && chip.memory()[101] == 0xFF;
+    }
+
+    bool checkWideRangeInWindows()
+    {
+        // Поля дальше MAX_FIELD_SPAN друг от друга: по кадру READ на окно
+        TestChip chip;
+        const BitField fields[3] = {{500, 0, 16}, {2, 4, 8}, {2 + EEPROM25LC040A::MAX_FIELD_SPAN, 3, 20}};
+        const uint32_t written[3] = {0xBEEF, 0x5A, 0xABCDE};
+        chip.eeprom.writeFields(fields, 3, written);
+
+        chip.eeprom.resetBusStatistics();
+        uint32_t values[3] = {};
+        chip.eeprom.readFields(fields, 3, values);
+
+        return chip.eeprom.busStatistics().frames == 3 &&
+               values[0] == written[0] && values[1] == written[1] && values[2] == written[2] &&
+               chip.eeprom.readBits(500, 0, 16) == 0xBEEF;
+    }
+
+    bool checkInvalidFields()
+    {
+        TestChip chip;
+        const BitField fields[3] = {{10, 0, 0}, {511, 4, 8}, {12, 0, 8}};
+        const uint32_t written[3] = {1, 0xAA, 0x42};
+        chip.eeprom.writeFields(fields, 3, written);
+
+        uint32_t values[3] = {7, 7, 7};
+        chip.eeprom.readFields(fields, 3, values);
+        return values[0] == 0 && values[1] == 0 && values[2] == 0x42 &&
+               chip.memory()[511] == 0xFF;
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"bits_round_trip", checkBitsRoundTrip},
+        {"fields_match_read_bits", checkFieldsMatchReadBits},
+        {"fields_one_frame", checkFieldsOneFrame},
+        {"offset_past_first_byte", checkOffsetPastFirstByte},
+        {"wide_range_in_windows", checkWideRangeInWindows},
+        {"invalid_fields", checkInvalidFields},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
@@ -0,0 +1,77 @@
+#include "eeprom_test.hpp"
+#include "eeprom_page_hash_tree.hpp"
+
+/**
+ * @file eeprom_hash_tree_test.cpp
+ * @brief Тест дерева хешей страниц EEPROMPageHashTree.
+ */
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+
+    bool checkDetectsCorruptedPage()
+    {
+        TestChip chip;
+        EEPROMPageHashTree tree(chip.eeprom, 0, 16, 16 * PAGE);
+        if (!tree.valid())
+        {
+            return false;
+        }
+
+        tree.build();
+        const uint8_t data[3] = {1, 2, 3};
+        tree.write(20, data, sizeof(data));
+        if (!tree.load() || !tree.verify(0, 16 * PAGE))
+        {
+            return false;
+        }
+
+        // Повреждена только страница 1
+        chip.simulator.memory()[21] ^= 0xFF;
+        return !tree.verify(16, PAGE) && tree.verify(0, PAGE) && tree.verify(2 * PAGE, 14 * PAGE);
+    }
+
+    bool checkReloadAfterRestart()
+    {
+        TestChip chip;
+        {
+            EEPROMPageHashTree tree(chip.eeprom, 4, 8, 0);
+            tree.build();
+        }
+
+        EEPROMPageHashTree reopened(chip.eeprom, 4, 8, 0);
+        if (!reopened.load() || !reopened.verify(4 * PAGE, 8 * PAGE))
+        {
+            return false;
+        }
+
+        // Повреждённый узел дерева обнаруживается при загрузке
+        chip.simulator.memory()[0] ^= 0x01;
+        return !reopened.load();
+    }
+
+    bool checkInvalidGeometry()
+    {
+        TestChip chip;
+        const EEPROMPageHashTree not_power_of_two(chip.eeprom, 0, 12, 16 * PAGE);
+        const EEPROMPageHashTree past_end(chip.eeprom, 24, 16, 0);
+        const EEPROMPageHashTree tree_past_end(chip.eeprom, 0, 16, 500);
+        const EEPROMPageHashTree overlapping(chip.eeprom, 0, 16, 8 * PAGE);
+
+        return !not_power_of_two.valid() && !past_end.valid() &&
+               !tree_past_end.valid() && !overlapping.valid() &&
+               not_power_of_two.treeSize() == 0 && !overlapping.verify(0, PAGE);
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"detects_corrupted_page", checkDetectsCorruptedPage},
+        {"reload_after_restart", checkReloadAfterRestart},
+        {"invalid_geometry", checkInvalidGeometry},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
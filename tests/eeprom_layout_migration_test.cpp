@@ -0,0 +1,219 @@
+#include "eeprom_test.hpp"
+#include "eeprom_layout_migration.hpp"
+#include <cstring>
+
+/**
+ * @file eeprom_layout_migration_test.cpp
+ * @brief Тест миграции между раскладками EEPROMLayoutMigration.
+ *
+ * Главная проверка - продолжение после пропадания питания: миграция
+ * прерывается перед каждым циклом записи (и посреди него), затем
+ * прерывается и восстановление, и результат сверяется с эталоном.
+ */
+
+namespace
+{
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+    constexpr std::size_t JOURNAL = CAPACITY - EEPROMLayoutMigration::JOURNAL_SIZE;
+
+    /**
+     * @brief Пара раскладок.
+     */
+    struct Layouts
+    {
+        const FieldPlacement *oldLayout;
+        std::size_t oldCount;
+        const FieldPlacement *newLayout;
+        std::size_t newCount;
+    };
+
+    // Перенос поля 1 в страницу 2, рост поля 2, новое поле 4: без циклов
+    const FieldPlacement MOVE_OLD[] = {{1, 0, 8}, {2, 16, 8}, {3, 40, 4}};
+    const FieldPlacement MOVE_NEW[] = {{1, 32, 8}, {2, 16, 12}, {3, 40, 4}, {4, 64, 4}};
+    const Layouts MOVE = {MOVE_OLD, 3, MOVE_NEW, 4};
+
+    // Обмен полями между страницами 0 и 1: страницы читают друг друга
+    const FieldPlacement SWAP_OLD[] = {{1, 0, 8}, {2, 16, 8}, {5, 100, 4}};
+    const FieldPlacement SWAP_NEW[] = {{1, 16, 8}, {2, 0, 8}, {5, 100, 4}};
+    const Layouts SWAP = {SWAP_OLD, 3, SWAP_NEW, 3};
+
+    /**
+     * @brief Выполнить миграцию новым объектом, как после перезапуска.
+     */
+    bool migrate(TestChip &chip, const Layouts &layouts)
+    {
+        EEPROMLayoutMigration migration(chip.eeprom,
+                                        layouts.oldLayout, layouts.oldCount,
+                                        layouts.newLayout, layouts.newCount,
+                                        JOURNAL);
+        return migration.run();
+    }
+
+    /**
+     * @brief Исходное содержимое микросхемы.
+     */
+    void fillInitial(TestChip &chip)
+    {
+        fillPattern(chip.simulator.memory(), CAPACITY, 1);
+    }
+
+    /**
+     * @brief Ожидаемое содержимое области данных после миграции.
+     */
+    void buildExpected(const Layouts &layouts, const uint8_t *initial, uint8_t *expected)
+    {
+        std::memcpy(expected, initial, JOURNAL);
+        for (std::size_t i = 0; i < layouts.newCount; ++i)
+        {
+            const FieldPlacement &field = layouts.newLayout[i];
+            const FieldPlacement *old = nullptr;
+            for (std::size_t j = 0; j < layouts.oldCount; ++j)
+            {
+                old = layouts.oldLayout[j].id == field.id ? &layouts.oldLayout[j] : old;
+            }
+
+            for (std::size_t offset = 0; offset < field.size; ++offset)
+            {
+                expected[field.address + offset] = (old != nullptr && offset < old->size)
+                                                       ? initial[old->address + offset]
+                                                       : 0xFF;
+            }
+        }
+    }
+
+    bool matchesExpected(const TestChip &chip, const Layouts &layouts)
+    {
+        TestChip reference;
+        fillInitial(reference);
+
+        uint8_t expected[JOURNAL];
+        buildExpected(layouts, reference.memory(), expected);
+        return std::memcmp(chip.memory(), expected, JOURNAL) == 0;
+    }
+
+    bool checkMovesChangedPagesOnly()
+    {
+        TestChip chip;
+        fillInitial(chip);
+
+        // Меняются страницы 1, 2 и 4: три цикла на страницу и один на завершение
+        if (!migrate(chip, MOVE) || !matchesExpected(chip, MOVE) ||
+            chip.simulator.statistics().writeCycles != 3 * 3 + 1)
+        {
+            return false;
+        }
+
+        // Повторный запуск завершённой миграции ничего не пишет
+        return migrate(chip, MOVE) && chip.simulator.statistics().writeCycles == 3 * 3 + 1;
+    }
+
+    bool checkSwapBetweenPages()
+    {
+        TestChip chip;
+        fillInitial(chip);
+
+        EEPROMLayoutMigration migration(chip.eeprom, SWAP_OLD, 3, SWAP_NEW, 3, JOURNAL);
+        if (!migration.plan() || migration.stepCount() != 3 ||
+            migration.stepKind(0) != EEPROMLayoutMigration::StepKind::STAGE ||
+            migration.stepKind(2) != EEPROMLayoutMigration::StepKind::COMMIT ||
+            migration.stepPage(0) != migration.stepPage(2))
+        {
+            return false;
+        }
+
+        // Страница через буфер: два цикла в буфер и два на место, вторая - три, завершение - один
+        return migration.run() && matchesExpected(chip, SWAP) &&
+               chip.simulator.statistics().writeCycles == 4 + 3 + 1;
+    }
+
+    /**
+     * @brief Пропадание питания перед каждым циклом записи и во время него.
+     *
+     * Питание пропадает после first циклов миграции, затем после second
+     * циклов восстановления; третий запуск должен довести миграцию до конца.
+     */
+    bool checkPowerLoss(const Layouts &layouts)
+    {
+        TestChip full;
+        fillInitial(full);
+        if (!migrate(full, layouts))
+        {
+            return false;
+        }
+        const uint64_t total = full.simulator.statistics().writeCycles;
+
+        const std::size_t torn_variants[] = {0, 7};
+        for (std::size_t torn : torn_variants)
+        {
+            for (uint64_t first = 0; first < total; ++first)
+            {
+                for (uint64_t second = 0; second <= total; ++second)
+                {
+                    TestChip chip;
+                    fillInitial(chip);
+
+                    chip.simulator.cutPowerAfter(first, torn);
+                    migrate(chip, layouts);
+                    chip.simulator.restorePower();
+
+                    chip.simulator.cutPowerAfter(second, torn);
+                    migrate(chip, layouts);
+                    chip.simulator.restorePower();
+
+                    if (!migrate(chip, layouts) || !matchesExpected(chip, layouts))
+                    {
+                        std::printf("  torn=%zu first=%llu second=%llu\n", torn,
+                                    static_cast<unsigned long long>(first),
+                                    static_cast<unsigned long long>(second));
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool checkPowerLossMove()
+    {
+        return checkPowerLoss(MOVE);
+    }
+
+    bool checkPowerLossSwap()
+    {
+        return checkPowerLoss(SWAP);
+    }
+
+    bool checkForeignJournalRejected()
+    {
+        TestChip chip;
+        fillInitial(chip);
+
+        // Прерванная на середине миграция MOVE
+        chip.simulator.cutPowerAfter(4);
+        migrate(chip, MOVE);
+        chip.simulator.restorePower();
+
+        // Другая миграция не продолжает чужой журнал и ничего не пишет
+        chip.simulator.resetStatistics();
+        if (migrate(chip, SWAP) || chip.simulator.statistics().writeCycles != 0)
+        {
+            return false;
+        }
+
+        return migrate(chip, MOVE) && matchesExpected(chip, MOVE);
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"moves_changed_pages_only", checkMovesChangedPagesOnly},
+        {"swap_between_pages", checkSwapBetweenPages},
+        {"power_loss_move", checkPowerLossMove},
+        {"power_loss_swap", checkPowerLossSwap},
+        {"foreign_journal_rejected", checkForeignJournalRejected},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
@@ -0,0 +1,105 @@
+#include "eeprom_test.hpp"
+#include "eeprom_layout_optimizer.hpp"
+
+/**
+ * @file eeprom_layout_optimizer_test.cpp
+ * @brief Тест оптимизатора размещения полей FieldLayoutOptimizer.
+ */
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+
+    // Четыре поля в разных страницах; обновляются парами 1+3 и 2+4
+    const FieldPlacement FIELDS[4] = {{1, 0, 4}, {2, 20, 4}, {3, 40, 4}, {4, 60, 4}};
+
+    void addPairedTrace(FieldLayoutOptimizer &optimizer)
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            optimizer.addWrite(0, 4);
+            optimizer.addWrite(40, 4);
+            optimizer.endBatch();
+            optimizer.addWrite(20, 4);
+            optimizer.addWrite(60, 4);
+            optimizer.endBatch();
+        }
+    }
+
+    bool samePage(const FieldPlacement &a, const FieldPlacement &b)
+    {
+        return a.address / PAGE == b.address / PAGE &&
+               (a.address + a.size - 1) / PAGE == a.address / PAGE &&
+               (b.address + b.size - 1) / PAGE == b.address / PAGE;
+    }
+
+    bool checkCoUpdatedFieldsShareAPage()
+    {
+        FieldLayoutOptimizer optimizer(FIELDS, 4, 0, EEPROM25LC040A::CAPACITY_BYTES);
+        addPairedTrace(optimizer);
+        if (!optimizer.optimize())
+        {
+            return false;
+        }
+
+        const std::vector<FieldPlacement> &layout = optimizer.layout();
+        if (!FieldLayoutOptimizer::validLayout(layout) ||
+            !samePage(layout[0], layout[2]) || !samePage(layout[1], layout[3]) ||
+            optimizer.pagePrograms(optimizer.currentLayout()) != 20 ||
+            optimizer.pagePrograms(layout) != 10)
+        {
+            return false;
+        }
+
+        // План содержит ровно поля, адрес которых изменился
+        std::size_t moved = 0;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            moved += (layout[i].address != FIELDS[i].address) ? 1 : 0;
+        }
+        return optimizer.migrationPlan().size() == moved;
+    }
+
+    bool checkFailureKeepsLayout()
+    {
+        // 16 байт полей не помещаются в страницу 20..35 (с границы - ни одной страницы)
+        FieldLayoutOptimizer optimizer(FIELDS, 4, 20, PAGE);
+        addPairedTrace(optimizer);
+        if (optimizer.optimize())
+        {
+            return false;
+        }
+
+        const std::vector<FieldPlacement> &layout = optimizer.layout();
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            if (layout[i].address != FIELDS[i].address)
+            {
+                return false;
+            }
+        }
+        return optimizer.migrationPlan().empty();
+    }
+
+    bool checkInvalidLayoutRejected()
+    {
+        const FieldPlacement empty[2] = {{1, 0, 4}, {2, 8, 0}};
+        const FieldPlacement past_end[1] = {{1, 510, 4}};
+
+        FieldLayoutOptimizer with_empty(empty, 2, 0, EEPROM25LC040A::CAPACITY_BYTES);
+        FieldLayoutOptimizer with_past_end(past_end, 1, 0, EEPROM25LC040A::CAPACITY_BYTES);
+        FieldLayoutOptimizer bad_region(FIELDS, 4, 500, 100);
+        return !with_empty.optimize() && !with_past_end.optimize() && !bad_region.optimize();
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"co_updated_fields_share_page", checkCoUpdatedFieldsShareAPage},
+        {"failure_keeps_layout", checkFailureKeepsLayout},
+        {"invalid_layout_rejected", checkInvalidLayoutRejected},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
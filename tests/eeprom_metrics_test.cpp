@@ -0,0 +1,190 @@
+#include "eeprom_test.hpp"
+#include "eeprom_metrics.hpp"
+#include "eeprom_metrics_file.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <unistd.h>
+
+/**
+ * @file eeprom_metrics_test.cpp
+ * @brief Тест метрик EEPROM и их вывода в формате Prometheus.
+ */
+
+namespace
+{
+    /**
+     * @brief Микросхема со сборщиком метрик на модельном времени.
+     */
+    struct MeteredChip
+    {
+        TestChip chip;
+        EEPROMMetrics metrics;
+        char text[32768];
+
+        MeteredChip() : chip(), metrics(chip.eeprom, testClock), text{}
+        {
+            testClockSource = &chip.simulator;
+            chip.eeprom.addListener(&metrics);
+        }
+
+        /**
+         * @brief Текст метрик содержит строку line.
+         */
+        bool exported(const char *line, const EEPROMShadow::Statistics *shadow = nullptr, const char *chip = "a")
+        {
+            return formatPrometheus(metrics, shadow, chip, text, sizeof(text)) > 0 &&
+                   std::strstr(text, line) != nullptr;
+        }
+    };
+
+    bool checkCountsOperations()
+    {
+        MeteredChip chip;
+        uint8_t data[40];
+        fillPattern(data, sizeof(data), 1);
+        chip.chip.eeprom.writeArray(0, data, sizeof(data));
+        chip.chip.eeprom.writeByte(5, 0x42);
+        chip.chip.eeprom.readArray(0, data, 16);
+
+        // Три страницы writeArray и страница 0 ещё раз от writeByte
+        const EEPROMMetrics::OperationStatistics &written = chip.metrics.operation(EEPROMOperation::WRITE_ARRAY);
+        const EEPROMMetrics::OperationStatistics &read = chip.metrics.operation(EEPROMOperation::READ_ARRAY);
+        return written.count == 1 && written.bytes == sizeof(data) && read.count == 1 && read.bytes == 16 &&
+               chip.metrics.operation(EEPROMOperation::WRITE_BYTE).count == 1 &&
+               chip.metrics.operation(EEPROMOperation::READ_BYTE).count == 0 &&
+               chip.metrics.pageWrites(0) == 2 && chip.metrics.pageWrites(1) == 1 &&
+               chip.metrics.pageWrites(2) == 1 && chip.metrics.pageWrites(3) == 0;
+    }
+
+    bool checkLatencyQuantiles()
+    {
+        MeteredChip chip;
+        if (chip.metrics.latencyQuantileUs(EEPROMOperation::WRITE_BYTE, 0.5) != 0)
+        {
+            return false;
+        }
+
+        // Девять коротких чтений и одна запись с ожиданием tWC
+        for (std::size_t i = 0; i < 9; ++i)
+        {
+            chip.chip.eeprom.readByte(i);
+        }
+        chip.chip.eeprom.writeByte(0, 1);
+
+        const EEPROMMetrics::OperationStatistics &write = chip.metrics.operation(EEPROMOperation::WRITE_BYTE);
+        const EEPROMMetrics::OperationStatistics &read = chip.metrics.operation(EEPROMOperation::READ_BYTE);
+        const uint64_t writeBound = chip.metrics.latencyQuantileUs(EEPROMOperation::WRITE_BYTE, 0.99);
+        const uint64_t readBound = chip.metrics.latencyQuantileUs(EEPROMOperation::READ_BYTE, 0.99);
+        return writeBound >= write.latencySumUs && writeBound < 2 * write.latencySumUs &&
+               readBound * 9 >= read.latencySumUs && readBound < writeBound &&
+               chip.metrics.latencyQuantileUs(EEPROMOperation::READ_BYTE, 0.0) <= readBound;
+    }
+
+    bool checkPrometheusText()
+    {
+        MeteredChip chip;
+        chip.chip.eeprom.writeByte(5, 0x42);
+        chip.chip.eeprom.readByte(5);
+
+        char line[128];
+        const EEPROMBusStatistics &bus = chip.chip.eeprom.busStatistics();
+        std::snprintf(line, sizeof(line), "eeprom_bus_frames_total{chip=\"a\"} %llu\n",
+                      static_cast<unsigned long long>(bus.frames));
+
+        return chip.exported("# TYPE eeprom_operations_total counter\n") &&
+               chip.exported("eeprom_operations_total{chip=\"a\",op=\"WRITE_BYTE\"} 1\n") &&
+               chip.exported("eeprom_operations_total{chip=\"a\",op=\"WRITE_ARRAY\"} 0\n") &&
+               chip.exported("eeprom_operation_duration_microseconds_bucket{chip=\"a\",op=\"READ_BYTE\",le=\"+Inf\"} 1\n") &&
+               chip.exported("eeprom_operation_duration_quantile_microseconds{chip=\"a\",op=\"WRITE_BYTE\",quantile=\"0.99\"}") &&
+               !chip.exported("op=\"WRITE_ARRAY\",le=") &&
+               chip.exported(line) && chip.exported("eeprom_write_cycles_total{chip=\"a\"} 1\n") &&
+               chip.exported("eeprom_page_writes_total{chip=\"a\",page=\"0\"} 1\n") &&
+               !chip.exported("eeprom_shadow_");
+    }
+
+    bool checkShadowAndLabels()
+    {
+        MeteredChip chip;
+        const EEPROMShadow::Statistics shadow{5, 1, 3, 7};
+        if (!chip.exported("eeprom_shadow_coherency_hits_total{chip=\"a\"} 5\n", &shadow) ||
+            !chip.exported("eeprom_shadow_coherency_misses_total{chip=\"a\"} 1\n", &shadow) ||
+            !chip.exported("eeprom_shadow_pages_programmed_total{chip=\"a\"} 3\n", &shadow) ||
+            !chip.exported("eeprom_shadow_pages_skipped_total{chip=\"a\"} 7\n", &shadow))
+        {
+            return false;
+        }
+
+        // Кавычка, обратная косая черта и перевод строки в метке экранируются
+        return chip.exported("eeprom_bus_bytes_total{chip=\"x\\\"y\\\\z\\n\"} 0\n", nullptr, "x\"y\\z\n");
+    }
+
+    bool checkSmallBuffer()
+    {
+        MeteredChip chip;
+        const std::size_t length = formatPrometheus(chip.metrics, nullptr, "a", chip.text, sizeof(chip.text));
+        return length > 0 && formatPrometheus(chip.metrics, nullptr, "a", chip.text, length) == 0 &&
+               chip.text[0] == '\0' &&
+               formatPrometheus(chip.metrics, nullptr, "a", chip.text, length + 1) == length;
+    }
+
+    bool checkMetricsFile()
+    {
+        char directory[] = "/tmp/eeprom_metrics_test.XXXXXX";
+        if (mkdtemp(directory) == nullptr)
+        {
+            return false;
+        }
+        const std::string path = std::string(directory) + "/eeprom.prom";
+
+        MeteredChip chip;
+        chip.chip.eeprom.writeByte(0, 1);
+        const std::size_t length = formatPrometheus(chip.metrics, nullptr, "a", chip.text, sizeof(chip.text));
+        const bool written = writeMetricsFile(path.c_str(), chip.text, length) &&
+                             writeMetricsFile(path.c_str(), chip.text, length);
+
+        // Файл содержит текст целиком, временных файлов не осталось
+        std::string content;
+        if (std::FILE *file = std::fopen(path.c_str(), "rb"))
+        {
+            char buffer[4096];
+            std::size_t got = 0;
+            while ((got = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+            {
+                content.append(buffer, got);
+            }
+            std::fclose(file);
+        }
+
+        std::size_t entries = 0;
+        if (DIR *dir = opendir(directory))
+        {
+            while (const dirent *entry = readdir(dir))
+            {
+                entries += (entry->d_name[0] != '.') ? 1 : 0;
+            }
+            closedir(dir);
+        }
+
+        const bool missing = !writeMetricsFile((std::string(directory) + "/none/eeprom.prom").c_str(), "x", 1);
+        std::remove(path.c_str());
+        rmdir(directory);
+
+        return written && content == std::string(chip.text, length) && entries == 1 && missing;
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"counts_operations", checkCountsOperations},
+        {"latency_quantiles", checkLatencyQuantiles},
+        {"prometheus_text", checkPrometheusText},
+        {"shadow_and_labels", checkShadowAndLabels},
+        {"small_buffer", checkSmallBuffer},
+        {"metrics_file", checkMetricsFile},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
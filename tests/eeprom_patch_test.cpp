@@ -0,0 +1,185 @@
+#include "eeprom_test.hpp"
+#include "eeprom_patch.hpp"
+#include <cstring>
+
+/**
+ * @file eeprom_patch_test.cpp
+ * @brief Тест двоичных патчей образа EEPROM.
+ */
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+
+    void storeLe16(uint8_t *data, std::size_t value)
+    {
+        data[0] = static_cast<uint8_t>(value & 0xFF);
+        data[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+    }
+
+    /**
+     * @brief Микросхема с исходным образом и новый образ.
+     */
+    struct PatchRig
+    {
+        TestChip chip;
+        uint8_t base[CAPACITY];
+        uint8_t target[CAPACITY];
+        uint8_t patch[CAPACITY];
+
+        PatchRig() : chip(), base{}, target{}, patch{}
+        {
+            fillPattern(base, CAPACITY, 5);
+            std::memcpy(target, base, CAPACITY);
+            std::memcpy(chip.simulator.memory(), base, CAPACITY);
+        }
+
+        std::size_t make() { return makePatch(base, target, patch, sizeof(patch)); }
+
+        bool chipHolds(const uint8_t *image) const { return std::memcmp(chip.memory(), image, CAPACITY) == 0; }
+    };
+
+    bool checkAppliesOnce()
+    {
+        PatchRig rig;
+        rig.target[3] = 0;
+        fillPattern(rig.target + 200, 40, 9);
+
+        const std::size_t size = rig.make();
+        if (size == 0 || applyPatch(rig.chip.eeprom, rig.patch, size) != EEPROMPatchResult::APPLIED ||
+            !rig.chipHolds(rig.target))
+        {
+            return false;
+        }
+
+        // Повторная доставка ничего не пишет
+        const uint64_t cycles = rig.chip.simulator.statistics().writeCycles;
+        return applyPatch(rig.chip.eeprom, rig.patch, size) == EEPROMPatchResult::ALREADY_APPLIED &&
+               rig.chip.simulator.statistics().writeCycles == cycles;
+    }
+
+    bool checkOnePageProgramPerPage()
+    {
+        PatchRig rig;
+
+        // Два участка одной страницы (разрыв длиннее заголовка участка)
+        // и участок через границу страниц 1 и 2: три цикла записи
+        rig.target[5 * PAGE + 3] ^= 0xFF;
+        rig.target[5 * PAGE + 12] ^= 0xFF;
+        for (std::size_t i = 2 * PAGE - 2; i < 2 * PAGE + 2; ++i)
+        {
+            rig.target[i] ^= 0xFF;
+        }
+
+        const std::size_t size = rig.make();
+        return size == PATCH_HEADER_SIZE + 3 * PATCH_RUN_HEADER_SIZE + 6 &&
+               applyPatch(rig.chip.eeprom, rig.patch, size) == EEPROMPatchResult::APPLIED &&
+               rig.chipHolds(rig.target) && rig.chip.simulator.statistics().writeCycles == 3;
+    }
+
+    bool checkMergesCloseChanges()
+    {
+        PatchRig rig;
+
+        // Разрыв в PATCH_RUN_HEADER_SIZE байт дешевле отдельного участка
+        rig.target[100] ^= 0xFF;
+        rig.target[100 + PATCH_RUN_HEADER_SIZE + 1] ^= 0xFF;
+        const std::size_t size = rig.make();
+        return size == PATCH_HEADER_SIZE + PATCH_RUN_HEADER_SIZE + PATCH_RUN_HEADER_SIZE + 2 &&
+               applyPatch(rig.chip.eeprom, rig.patch, size) == EEPROMPatchResult::APPLIED &&
+               rig.chipHolds(rig.target);
+    }
+
+    bool checkEmptyPatch()
+    {
+        PatchRig rig;
+        const std::size_t size = rig.make();
+        return size == PATCH_HEADER_SIZE &&
+               applyPatch(rig.chip.eeprom, rig.patch, size) == EEPROMPatchResult::ALREADY_APPLIED &&
+               rig.chip.simulator.statistics().writeCycles == 0;
+    }
+
+    bool checkBaseMismatch()
+    {
+        PatchRig rig;
+        rig.target[10] ^= 0xFF;
+        const std::size_t size = rig.make();
+
+        // Микросхема содержит другой образ - запись не начинается
+        rig.chip.simulator.memory()[400] ^= 0x01;
+        return applyPatch(rig.chip.eeprom, rig.patch, size) == EEPROMPatchResult::BASE_MISMATCH &&
+               rig.chip.simulator.statistics().writeCycles == 0;
+    }
+
+    bool checkPatchBufferTooSmall()
+    {
+        PatchRig rig;
+        fillPattern(rig.target, 64, 77);
+        return makePatch(rig.base, rig.target, rig.patch, PATCH_HEADER_SIZE + 8) == 0 &&
+               makePatch(rig.base, rig.target, rig.patch, PATCH_HEADER_SIZE - 1) == 0;
+    }
+
+    bool checkRejectsBadPatches()
+    {
+        PatchRig rig;
+        rig.target[20] ^= 0xFF;
+        rig.target[300] ^= 0xFF;
+        const std::size_t size = rig.make();
+
+        auto rejected = [&rig](const uint8_t *patch, std::size_t length) {
+            return applyPatch(rig.chip.eeprom, patch, length) == EEPROMPatchResult::BAD_FORMAT;
+        };
+
+        uint8_t bad[CAPACITY];
+        std::memcpy(bad, rig.patch, size);
+        bad[0] = 'X';
+        if (!rejected(bad, size) || !rejected(rig.patch, size - 1) || !rejected(nullptr, size))
+        {
+            return false;
+        }
+
+        // Лишний байт после последнего участка
+        std::memcpy(bad, rig.patch, size);
+        if (!rejected(bad, size + 1))
+        {
+            return false;
+        }
+
+        // Участки не по возрастанию, пустой участок, участок за пределами микросхемы
+        const std::size_t second = PATCH_HEADER_SIZE + PATCH_RUN_HEADER_SIZE + 1;
+        std::memcpy(bad, rig.patch, size);
+        storeLe16(bad + second, 10);
+        if (!rejected(bad, size))
+        {
+            return false;
+        }
+
+        std::memcpy(bad, rig.patch, size);
+        storeLe16(bad + second + 2, 0);
+        if (!rejected(bad, size - 1))
+        {
+            return false;
+        }
+
+        std::memcpy(bad, rig.patch, size);
+        storeLe16(bad + second, CAPACITY);
+        return rejected(bad, size) && rig.chip.simulator.statistics().writeCycles == 0 &&
+               rig.chipHolds(rig.base);
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"applies_once", checkAppliesOnce},
+        {"one_program_per_page", checkOnePageProgramPerPage},
+        {"merges_close_changes", checkMergesCloseChanges},
+        {"empty_patch", checkEmptyPatch},
+        {"base_mismatch", checkBaseMismatch},
+        {"patch_buffer_too_small", checkPatchBufferTooSmall},
+        {"rejects_bad_patches", checkRejectsBadPatches},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
@@ -0,0 +1,170 @@
+#include "eeprom_test.hpp"
+#include "eeprom_profiler.hpp"
+#include <cinttypes>
+#include <cstring>
+
+/**
+ * @file eeprom_profiler_test.cpp
+ * @brief Тест профилировщика обращений к шине EEPROMCallSiteProfiler.
+ */
+
+namespace
+{
+    using Metric = EEPROMCallSiteProfiler::Metric;
+
+    /**
+     * @brief Микросхема с профилировщиком на модельном времени.
+     */
+    struct ProfiledChip
+    {
+        TestChip chip;
+        EEPROMCallSiteProfiler profiler;
+        char text[4096];
+
+        ProfiledChip() : chip(), profiler(chip.eeprom, testClock), text{}
+        {
+            testClockSource = &chip.simulator;
+            chip.eeprom.addListener(&profiler);
+        }
+
+        /**
+         * @brief Вывод показателя содержит строку line.
+         */
+        bool dumped(Metric metric, const char *line)
+        {
+            profiler.dumpFolded(text, sizeof(text), metric);
+            return std::strstr(text, line) != nullptr;
+        }
+    };
+
+    /**
+     * @brief Вложить depth областей с адресами из frames и записать байт.
+     */
+    void writeNested(ProfiledChip &chip, const char *frames, std::size_t depth)
+    {
+        if (depth == 0)
+        {
+            chip.chip.eeprom.writeByte(0, 1);
+            return;
+        }
+
+        EEPROMCallSiteProfiler::Scope scope(chip.profiler, static_cast<const void *>(frames));
+        writeNested(chip, frames + 1, depth - 1);
+    }
+
+    bool checkAttributesToScopes()
+    {
+        ProfiledChip chip;
+        chip.chip.eeprom.readByte(0);
+        {
+            EEPROMCallSiteProfiler::Scope outer(chip.profiler, "outer");
+            chip.chip.eeprom.readByte(1);
+            {
+                EEPROMCallSiteProfiler::Scope inner(chip.profiler, "inner");
+                chip.chip.eeprom.writeByte(5, 0x42);
+                chip.chip.eeprom.writeByte(6, 0x43);
+            }
+            chip.chip.eeprom.readByte(2);
+        }
+
+        return chip.profiler.siteCount() == 3 && !chip.profiler.overflowed() &&
+               chip.dumped(Metric::CALLS, "untagged;READ_BYTE 1\n") &&
+               chip.dumped(Metric::CALLS, "outer;READ_BYTE 2\n") &&
+               chip.dumped(Metric::CALLS, "outer;inner;WRITE_BYTE 2\n") &&
+               chip.dumped(Metric::WRITE_CYCLES, "outer;inner;WRITE_BYTE 2\n") &&
+               !chip.dumped(Metric::WRITE_CYCLES, "READ_BYTE");
+    }
+
+    bool checkCountsBusCost()
+    {
+        ProfiledChip chip;
+        uint8_t data[40];
+        fillPattern(data, sizeof(data), 1);
+        {
+            EEPROM_PROFILE_FUNCTION(chip.profiler);
+            chip.chip.eeprom.writeArray(0, data, sizeof(data));
+        }
+
+        // Три страницы: всё, что прошло по шине, отнесено к одному месту
+        const EEPROMCallSiteProfiler::SiteStatistics &stats = chip.profiler.siteStatistics(0);
+        const EEPROMBusStatistics &bus = chip.chip.eeprom.busStatistics();
+        return chip.profiler.siteCount() == 1 && stats.calls == 1 && stats.writeCycles == 3 &&
+               stats.frames == bus.frames && stats.clocks == bus.bytes * 8 &&
+               stats.statusPolls == bus.statusPolls && stats.waitUs == bus.delayUs &&
+               stats.wallUs >= stats.waitUs && stats.wallUs > 0 &&
+               chip.dumped(Metric::WRITE_CYCLES, "checkCountsBusCost;WRITE_ARRAY 3\n");
+    }
+
+    bool checkAddressFrames()
+    {
+        ProfiledChip chip;
+        static const char frames[EEPROMCallSiteProfiler::MAX_DEPTH + 2] = {};
+
+        // Области глубже MAX_DEPTH учитываются как самая глубокая сохранённая
+        writeNested(chip, frames, EEPROMCallSiteProfiler::MAX_DEPTH);
+        writeNested(chip, frames, EEPROMCallSiteProfiler::MAX_DEPTH + 2);
+        if (chip.profiler.siteCount() != 1 || chip.profiler.siteStatistics(0).calls != 2)
+        {
+            return false;
+        }
+
+        char line[32];
+        std::snprintf(line, sizeof(line), "0x%" PRIxPTR ";WRITE_BYTE 2\n",
+                      reinterpret_cast<uintptr_t>(frames + EEPROMCallSiteProfiler::MAX_DEPTH - 1));
+        return chip.dumped(Metric::CALLS, line);
+    }
+
+    bool checkDumpKeepsWholeLines()
+    {
+        ProfiledChip chip;
+        {
+            EEPROMCallSiteProfiler::Scope scope(chip.profiler, "first");
+            chip.chip.eeprom.readByte(0);
+        }
+        {
+            EEPROMCallSiteProfiler::Scope scope(chip.profiler, "second");
+            chip.chip.eeprom.readByte(0);
+        }
+
+        // Вторая строка не помещается и отбрасывается целиком
+        const std::size_t full = chip.profiler.dumpFolded(chip.text, sizeof(chip.text), Metric::CALLS);
+        const std::size_t first = std::strlen("first;READ_BYTE 1\n");
+        const std::size_t cut = chip.profiler.dumpFolded(chip.text, first + 4, Metric::CALLS);
+        return full == first + std::strlen("second;READ_BYTE 1\n") && cut == first &&
+               std::strcmp(chip.text, "first;READ_BYTE 1\n") == 0 &&
+               chip.profiler.dumpFolded(chip.text, first, Metric::CALLS) == 0 && chip.text[0] == '\0';
+    }
+
+    bool checkTableOverflow()
+    {
+        ProfiledChip chip;
+        static const char frames[EEPROMCallSiteProfiler::MAX_SITES + 1] = {};
+        for (const char &frame : frames)
+        {
+            EEPROMCallSiteProfiler::Scope scope(chip.profiler, static_cast<const void *>(&frame));
+            chip.chip.eeprom.readByte(0);
+        }
+
+        if (chip.profiler.siteCount() != EEPROMCallSiteProfiler::MAX_SITES || !chip.profiler.overflowed())
+        {
+            return false;
+        }
+
+        chip.profiler.clear();
+        chip.chip.eeprom.readByte(0);
+        return chip.profiler.siteCount() == 1 && !chip.profiler.overflowed();
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"attributes_to_scopes", checkAttributesToScopes},
+        {"counts_bus_cost", checkCountsBusCost},
+        {"address_frames", checkAddressFrames},
+        {"dump_keeps_whole_lines", checkDumpKeepsWholeLines},
+        {"table_overflow", checkTableOverflow},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
@@ -0,0 +1,327 @@
+#include "eeprom_test.hpp"
+#include "eeprom_shadow.hpp"
+#include <cstring>
+
+/**
+ * @file eeprom_shadow_test.cpp
+ * @brief Тест теневой копии EEPROMShadow.
+ */
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+
+    /**
+     * @brief Вызовы обработчика подписки.
+     */
+    struct ChangeLog
+    {
+        unsigned calls;
+        std::size_t address;
+        std::size_t length;
+    };
+
+    void onChange(std::size_t address, std::size_t length, void *context)
+    {
+        ChangeLog &log = *static_cast<ChangeLog *>(context);
+        ++log.calls;
+        log.address = address;
+        log.length = length;
+    }
+
+    /**
+     * @brief Порядок записи страниц на микросхему.
+     */
+    class WriteOrder : public EEPROMOperationListener
+    {
+    public:
+        void onOperationBegin(const EEPROMOperationInfo &info) override
+        {
+            if (info.op == EEPROMOperation::WRITE_ARRAY && count < sizeof(pages))
+            {
+                pages[count++] = static_cast<uint8_t>(info.address / PAGE);
+            }
+        }
+
+        void onOperationEnd(const EEPROMOperationInfo &) override {}
+
+        bool equals(const uint8_t *expected, std::size_t length) const
+        {
+            return count == length && std::memcmp(pages, expected, length) == 0;
+        }
+
+        uint8_t pages[32] = {};
+        std::size_t count = 0;
+    };
+
+    bool checkSubscriptionBatches()
+    {
+        TestChip chip;
+        EEPROMShadow shadow(chip.eeprom);
+        shadow.load();
+
+        ChangeLog inside{};
+        ChangeLog outside{};
+        shadow.subscribe(100, 50, onChange, &inside);
+        shadow.subscribe(300, 10, onChange, &outside);
+
+        // Два изменения в области - один вызов на sync() с охватывающим участком
+        shadow.data()[110] = 1;
+        shadow.data()[140] = 2;
+        shadow.data()[200] = 3;
+        shadow.sync();
+
+        // Повторная запись тех же значений изменений не даёт
+        shadow.data()[110] = 1;
+        shadow.sync();
+
+        return inside.calls == 1 && inside.address == 110 && inside.length == 31 &&
+               outside.calls == 0;
+    }
+
+    bool checkSubscriptionSpansTable()
+    {
+        // Таблица сумм (страницы 0-1) ниже данных и записывается после них
+        TestChip chip;
+        EEPROMShadow shadow(chip.eeprom);
+        shadow.enableCoherencyTable(0);
+        shadow.load();
+
+        ChangeLog log{};
+        shadow.subscribe(0, 4 * PAGE, onChange, &log);
+
+        shadow.data()[40] = 0x5A;
+        shadow.sync();
+
+        // Изменились сумма страницы 2 (байт 2) и байт 40
+        return log.calls == 1 && log.address == 2 && log.length == 39;
+    }
+
+    bool checkSubscriptionAcrossBarrier()
+    {
+        // Группа до барьера (страница 5) записывается раньше страницы 1
+        TestChip chip;
+        EEPROMShadow shadow(chip.eeprom);
+        shadow.load();
+
+        ChangeLog log{};
+        shadow.subscribe(0, 6 * PAGE, onChange, &log);
+
+        shadow.data()[5 * PAGE] = 1;
+        shadow.barrier();
+        shadow.data()[PAGE + 4] = 2;
+        shadow.sync();
+
+        return log.calls == 1 && log.address == PAGE + 4 && log.length == 4 * PAGE - 3;
+    }
+
+    bool checkCoherencyExternalRewrite()
+    {
+        constexpr std::size_t TABLE = EEPROM25LC040A::CAPACITY_BYTES - EEPROMShadow::PAGE_COUNT;
+
+        TestChip chip;
+        EEPROMShadow shadow(chip.eeprom);
+        shadow.enableCoherencyTable(TABLE);
+        shadow.load();
+        shadow.data()[40] = 0x5A;
+        shadow.sync();
+
+        ChangeLog log{};
+        shadow.subscribe(96, 16, onChange, &log);
+
+        // Без внешних изменений - один короткий кадр чтения таблицы
+        chip.eeprom.resetBusStatistics();
+        if (shadow.checkCoherency() != 0 || chip.eeprom.busStatistics().frames != 1)
+        {
+            return false;
+        }
+
+        // Программатор меняет данные вместе с таблицей сумм
+        EEPROMShadow programmer(chip.eeprom);
+        programmer.enableCoherencyTable(TABLE);
+        programmer.load();
+        programmer.data()[100] = 0x11;
+        programmer.sync();
+
+        const uint32_t reloaded = shadow.checkCoherency();
+        const EEPROMShadow::Statistics &stats = shadow.statistics();
+        return reloaded == (1u << (100 / PAGE)) && shadow.data()[100] == 0x11 &&
+               shadow.data()[40] == 0x5A && shadow.dirtyPages() == 0 &&
+               log.calls == 1 && log.address == 100 && log.length == 1 &&
+               stats.coherencyMisses == 1 && stats.coherencyHits == 2 * (EEPROMShadow::PAGE_COUNT - 2) - 1;
+    }
+
+    bool checkDurabilityLevels()
+    {
+        TestChip chip;
+        testClockSource = &chip.simulator;
+        EEPROMShadow shadow(chip.eeprom);
+        shadow.setFlushDelay(testClock, 1000);
+        shadow.load();
+
+        const uint8_t value = 0x5A;
+        // DURABLE первой: её tWC не должен съесть срок BUFFERED-записи
+        shadow.write(80, &value, 1, EEPROMShadow::Durability::DURABLE);
+        shadow.write(10, &value, 1, EEPROMShadow::Durability::VOLATILE);
+        shadow.write(40, &value, 1, EEPROMShadow::Durability::BUFFERED);
+        if (chip.memory()[10] == value || chip.memory()[40] == value || chip.memory()[80] != value)
+        {
+            return false;
+        }
+
+        // BUFFERED - не раньше срока и не позже первого poll() после него
+        if (shadow.poll() != 0 || chip.memory()[40] == value)
+        {
+            return false;
+        }
+        chip.simulator.delay_us(2000);
+        if (shadow.poll() != 1 || chip.memory()[40] != value || chip.memory()[10] == value)
+        {
+            return false;
+        }
+
+        return shadow.sync() == 1 && chip.memory()[10] == value && shadow.dirtyPages() == 0;
+    }
+
+    bool checkBufferedWithoutClock()
+    {
+        // Без источника времени BUFFERED выполняется как DURABLE
+        TestChip chip;
+        EEPROMShadow shadow(chip.eeprom);
+        shadow.setFlushDelay(nullptr, 1000);
+        shadow.load();
+
+        const uint8_t value = 0x5A;
+        shadow.write(40, &value, 1, EEPROMShadow::Durability::BUFFERED);
+        if (chip.memory()[40] != value)
+        {
+            return false;
+        }
+
+        // Отключение часов записывает уже ожидающие страницы
+        testClockSource = &chip.simulator;
+        shadow.setFlushDelay(testClock, 1000);
+        shadow.write(60, &value, 1, EEPROMShadow::Durability::BUFFERED);
+        if (chip.memory()[60] == value)
+        {
+            return false;
+        }
+        shadow.setFlushDelay(nullptr, 1000);
+        return chip.memory()[60] == value && shadow.dirtyPages() == 0;
+    }
+
+    bool checkBarrierOrdersDurable()
+    {
+        // Заголовок (страница 1), записанный после барьера, не обгоняет данные (страница 5)
+        TestChip chip;
+        EEPROMShadow shadow(chip.eeprom);
+        shadow.load();
+        WriteOrder order;
+        chip.eeprom.addListener(&order);
+
+        const uint8_t payload = 0xAA;
+        const uint8_t header = 0xBB;
+        shadow.write(5 * PAGE, &payload, 1, EEPROMShadow::Durability::VOLATILE);
+        shadow.barrier();
+        shadow.write(PAGE, &header, 1, EEPROMShadow::Durability::DURABLE);
+
+        const uint8_t expected[] = {5, 1};
+        return order.equals(expected, sizeof(expected)) &&
+               chip.memory()[5 * PAGE] == payload && chip.memory()[PAGE] == header;
+    }
+
+    bool checkBarrierOrdersPoll()
+    {
+        // То же для отложенной записи заголовка через poll()
+        TestChip chip;
+        testClockSource = &chip.simulator;
+        EEPROMShadow shadow(chip.eeprom);
+        shadow.setFlushDelay(testClock, 1000);
+        shadow.load();
+        WriteOrder order;
+        chip.eeprom.addListener(&order);
+
+        const uint8_t payload = 0xAA;
+        const uint8_t header = 0xBB;
+        shadow.write(5 * PAGE, &payload, 1, EEPROMShadow::Durability::VOLATILE);
+        shadow.barrier();
+        shadow.write(PAGE, &header, 1, EEPROMShadow::Durability::BUFFERED);
+        chip.simulator.delay_us(2000);
+        shadow.poll();
+
+        const uint8_t expected[] = {5, 1};
+        return order.equals(expected, sizeof(expected)) && shadow.dirtyPages() == 0;
+    }
+
+    bool checkBarrierRewrittenGroup()
+    {
+        // Повторная запись страницы закрытой группы записывает эту группу,
+        // но не изменения после барьера
+        TestChip chip;
+        EEPROMShadow shadow(chip.eeprom);
+        shadow.load();
+        WriteOrder order;
+        chip.eeprom.addListener(&order);
+
+        const uint8_t value = 0x11;
+        shadow.write(2 * PAGE, &value, 1, EEPROMShadow::Durability::VOLATILE);
+        shadow.barrier();
+        shadow.write(7 * PAGE, &value, 1, EEPROMShadow::Durability::VOLATILE);
+        shadow.write(2 * PAGE + 1, &value, 1, EEPROMShadow::Durability::VOLATILE);
+
+        const uint8_t expected[] = {2};
+        return order.equals(expected, sizeof(expected)) &&
+               chip.memory()[2 * PAGE] == value && chip.memory()[2 * PAGE + 1] != value &&
+               shadow.dirtyPages() == ((1u << 2) | (1u << 7));
+    }
+
+    bool checkBarrierOverflow()
+    {
+        // Барьер сверх MAX_BARRIERS записывает закрытые группы по порядку;
+        // группы - страницы от последней вниз, изменение после них - страница 0
+        static_assert(EEPROMShadow::MAX_BARRIERS < EEPROMShadow::PAGE_COUNT,
+                      "сценарию нужна страница вне групп");
+        TestChip chip;
+        EEPROMShadow shadow(chip.eeprom);
+        shadow.load();
+        WriteOrder order;
+        chip.eeprom.addListener(&order);
+
+        uint8_t expected[EEPROMShadow::MAX_BARRIERS];
+        for (std::size_t i = 0; i < EEPROMShadow::MAX_BARRIERS; ++i)
+        {
+            const uint8_t value = static_cast<uint8_t>(i);
+            const std::size_t page = EEPROMShadow::PAGE_COUNT - 1 - i;
+            shadow.write(page * PAGE, &value, 1, EEPROMShadow::Durability::VOLATILE);
+            shadow.barrier();
+            expected[i] = static_cast<uint8_t>(page);
+        }
+        if (order.count != 0)
+        {
+            return false;
+        }
+
+        const uint8_t value = 0xEE;
+        shadow.write(0, &value, 1, EEPROMShadow::Durability::VOLATILE);
+        shadow.barrier();
+        return order.equals(expected, sizeof(expected)) && shadow.dirtyPages() == 1u;
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"subscription_batches", checkSubscriptionBatches},
+        {"subscription_spans_table", checkSubscriptionSpansTable},
+        {"subscription_across_barrier", checkSubscriptionAcrossBarrier},
+        {"coherency_external_rewrite", checkCoherencyExternalRewrite},
+        {"durability_levels", checkDurabilityLevels},
+        {"buffered_without_clock", checkBufferedWithoutClock},
+        {"barrier_orders_durable", checkBarrierOrdersDurable},
+        {"barrier_orders_poll", checkBarrierOrdersPoll},
+        {"barrier_rewritten_group", checkBarrierRewrittenGroup},
+        {"barrier_overflow", checkBarrierOverflow},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
@@ -0,0 +1,158 @@
+#include "eeprom_test.hpp"
+#include "eeprom_slow_log.hpp"
+#include <atomic>
+#include <thread>
+
+/**
+ * @file eeprom_slow_log_test.cpp
+ * @brief Тест журнала медленных операций EEPROMSlowOperationLog.
+ */
+
+namespace
+{
+    constexpr uint32_t THRESHOLD_US = 1000;
+
+    /**
+     * @brief Микросхема с журналом медленных операций на модельном времени.
+     */
+    template <std::size_t Capacity>
+    struct LoggedChip
+    {
+        TestChip chip;
+        EEPROMSlowOperationLog<Capacity> log;
+
+        explicit LoggedChip(EEPROMClockFunction clock = testClock)
+            : chip(), log(chip.eeprom, clock, THRESHOLD_US)
+        {
+            testClockSource = &chip.simulator;
+            chip.eeprom.addListener(&log);
+        }
+    };
+
+    bool checkLogsSlowWrites()
+    {
+        LoggedChip<4> chip;
+        chip.chip.eeprom.readByte(5);
+        const EEPROMBusStatistics before = chip.chip.eeprom.busStatistics();
+        const uint32_t start = testClock();
+        chip.chip.eeprom.writeByte(5, 0x42);
+        const EEPROMBusStatistics &after = chip.chip.eeprom.busStatistics();
+
+        // Только запись с ожиданием tWC дольше порога, с разбивкой по шине
+        EEPROMSlowOperation slow{};
+        if (!chip.log.tryPop(slow) || chip.log.tryPop(slow) || chip.log.dropped() != 0)
+        {
+            return false;
+        }
+        return slow.info.op == EEPROMOperation::WRITE_BYTE && slow.info.address == 5 &&
+               slow.startUs == start && slow.durationUs > THRESHOLD_US &&
+               slow.writeCycles == 1 && slow.statusPolls > 0 &&
+               slow.frames == after.frames - before.frames &&
+               slow.bytes == after.bytes - before.bytes &&
+               slow.statusPolls == after.statusPolls - before.statusPolls &&
+               slow.delayUs == after.delayUs - before.delayUs && slow.delayUs <= slow.durationUs;
+    }
+
+    bool checkThresholdChange()
+    {
+        LoggedChip<4> chip;
+        EEPROMSlowOperation slow{};
+
+        chip.log.setThreshold(UINT32_MAX);
+        chip.chip.eeprom.writeByte(0, 1);
+        if (chip.log.threshold() != UINT32_MAX || chip.log.tryPop(slow))
+        {
+            return false;
+        }
+
+        // Нулевой порог: в журнал попадает и чтение
+        chip.log.setThreshold(0);
+        chip.chip.eeprom.readByte(0);
+        return chip.log.tryPop(slow) && slow.info.op == EEPROMOperation::READ_BYTE &&
+               slow.writeCycles == 0;
+    }
+
+    bool checkDropsWhenFull()
+    {
+        LoggedChip<2> chip;
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            chip.chip.eeprom.writeByte(i, 1);
+        }
+        if (chip.log.dropped() != 1)
+        {
+            return false;
+        }
+
+        // Освободившееся место снова принимает записи; отброшена самая новая
+        EEPROMSlowOperation slow{};
+        if (!chip.log.tryPop(slow) || slow.info.address != 0)
+        {
+            return false;
+        }
+        chip.chip.eeprom.writeByte(3, 1);
+        return chip.log.tryPop(slow) && slow.info.address == 1 &&
+               chip.log.tryPop(slow) && slow.info.address == 3 &&
+               !chip.log.tryPop(slow) && chip.log.dropped() == 1;
+    }
+
+    bool checkWithoutClock()
+    {
+        LoggedChip<2> chip(nullptr);
+        chip.chip.eeprom.writeByte(0, 1);
+
+        EEPROMSlowOperation slow{};
+        return !chip.log.tryPop(slow) && chip.log.dropped() == 0;
+    }
+
+    bool checkConcurrentConsumer()
+    {
+        // Операции в отдельном потоке, потребитель забирает записи по мере поступления
+        constexpr std::size_t WRITES = 200;
+        LoggedChip<8> chip;
+        std::atomic<bool> finished{false};
+
+        std::thread producer([&chip, &finished]()
+                             {
+                                 for (std::size_t i = 0; i < WRITES; ++i)
+                                 {
+                                     chip.chip.eeprom.writeByte(i, static_cast<uint8_t>(i));
+                                 }
+                                 finished.store(true, std::memory_order_release); });
+
+        // Записи приходят по порядку; пропуски - только отброшенные
+        std::size_t popped = 0;
+        std::size_t next = 0;
+        bool ordered = true;
+        EEPROMSlowOperation slow{};
+        bool done = false;
+        while (!done)
+        {
+            // Флаг читается до выборки: после него в журнале уже всё
+            done = finished.load(std::memory_order_acquire);
+            while (chip.log.tryPop(slow))
+            {
+                ordered = ordered && slow.info.address >= next && slow.writeCycles == 1;
+                next = slow.info.address + 1;
+                ++popped;
+            }
+            std::this_thread::yield();
+        }
+        producer.join();
+
+        return ordered && popped + chip.log.dropped() == WRITES;
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"logs_slow_writes", checkLogsSlowWrites},
+        {"threshold_change", checkThresholdChange},
+        {"drops_when_full", checkDropsWhenFull},
+        {"without_clock", checkWithoutClock},
+        {"concurrent_consumer", checkConcurrentConsumer},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
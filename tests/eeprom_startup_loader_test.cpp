@@ -0,0 +1,132 @@
+#include "eeprom_test.hpp"
+#include "eeprom_startup_loader.hpp"
+#include <cstring>
+
+/**
+ * @file eeprom_startup_loader_test.cpp
+ * @brief Тест параллельной загрузки зеркал EEPROMStartupLoader.
+ */
+
+namespace
+{
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+    constexpr std::size_t BUSES = 3;
+    constexpr std::size_t CHIPS_PER_BUS = 2;
+
+    /**
+     * @brief Микросхема со своим зеркалом и своими данными.
+     */
+    struct ShadowChip
+    {
+        TestChip chip;
+        EEPROMShadow shadow;
+
+        ShadowChip() : chip(), shadow(chip.eeprom) {}
+    };
+
+    /**
+     * @brief Шины с микросхемами, заполненными разными данными.
+     */
+    struct Rig
+    {
+        ShadowChip chips[BUSES][CHIPS_PER_BUS];
+        EEPROMStartupLoader loader;
+
+        Rig()
+        {
+            for (std::size_t bus = 0; bus < BUSES; ++bus)
+            {
+                const std::size_t id = loader.addBus();
+                for (std::size_t chip = 0; chip < CHIPS_PER_BUS; ++chip)
+                {
+                    fillPattern(chips[bus][chip].chip.simulator.memory(), CAPACITY,
+                                static_cast<unsigned>(bus * CHIPS_PER_BUS + chip));
+                    loader.addChip(id, chips[bus][chip].shadow);
+                }
+            }
+        }
+
+        bool allLoaded() const
+        {
+            for (const auto &bus : chips)
+            {
+                for (const ShadowChip &chip : bus)
+                {
+                    if (std::memcmp(chip.shadow.data(), chip.chip.memory(), CAPACITY) != 0)
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    };
+
+    bool checkLoadsEveryChip()
+    {
+        Rig rig;
+        rig.loader.run();
+        if (!rig.allLoaded())
+        {
+            return false;
+        }
+
+        // Результаты - в порядке добавления; микросхемы одной шины - друг за другом
+        const std::vector<EEPROMStartupLoader::ChipResult> &results = rig.loader.results();
+        if (results.size() != BUSES * CHIPS_PER_BUS)
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const EEPROMStartupLoader::ChipResult &result = results[i];
+            if (result.bus != i / CHIPS_PER_BUS || result.chip != i % CHIPS_PER_BUS ||
+                result.startUs + result.loadTimeUs > rig.loader.totalTimeUs())
+            {
+                return false;
+            }
+            if (result.chip != 0 &&
+                result.startUs < results[i - 1].startUs + results[i - 1].loadTimeUs)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool checkRunAgain()
+    {
+        Rig rig;
+        rig.loader.run();
+
+        // Повторный run() перечитывает изменённые микросхемы и не накапливает результаты
+        rig.chips[1][1].chip.simulator.memory()[7] ^= 0xFF;
+        rig.loader.run();
+        return rig.allLoaded() && rig.loader.results().size() == BUSES * CHIPS_PER_BUS;
+    }
+
+    bool checkEmptyAndUnknownBus()
+    {
+        EEPROMStartupLoader loader;
+        TestChip chip;
+        EEPROMShadow shadow(chip.eeprom);
+        if (loader.totalTimeUs() != 0 || loader.addChip(0, shadow))
+        {
+            return false;
+        }
+
+        loader.run();
+        return loader.results().empty();
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"loads_every_chip", checkLoadsEveryChip},
+        {"run_again", checkRunAgain},
+        {"empty_and_unknown_bus", checkEmptyAndUnknownBus},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
@@ -0,0 +1,86 @@
+#ifndef EEPROM_TEST_HPP
+#define EEPROM_TEST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_25lc040a_simulator.hpp"
+#include "spi_bit_banging_helper.hpp"
+
+/**
+ * @file eeprom_test.hpp
+ * @brief Общие части тестов на симуляторе 25LC040A.
+ *
+ * Каждый тест - отдельная программа из набора сценариев (функций,
+ * возвращающих false при ошибке). Код возврата ненулевой, если не прошёл
+ * хотя бы один сценарий; тесты запускаются через ctest.
+ */
+
+/**
+ * @brief Микросхема на симуляторе.
+ */
+struct TestChip
+{
+    EEPROM25LC040ASimulator simulator;
+    SPIBitBangingHelper spi;
+    EEPROM25LC040A eeprom;
+
+    TestChip() : simulator(), spi(simulator), eeprom(spi) {}
+
+    const uint8_t *memory() const { return simulator.memory(); }
+};
+
+/**
+ * @brief Симулятор, время которого возвращает testClock().
+ */
+inline const EEPROM25LC040ASimulator *testClockSource = nullptr;
+
+/**
+ * @brief Модельное время testClockSource в микросекундах.
+ */
+inline uint32_t testClock()
+{
+    return static_cast<uint32_t>(testClockSource->elapsedNs() / 1000);
+}
+
+/**
+ * @brief Заполнить буфер воспроизводимыми данными.
+ */
+inline void fillPattern(uint8_t *data, std::size_t length, unsigned seed)
+{
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        data[i] = static_cast<uint8_t>(i * 7 + seed);
+    }
+}
+
+/**
+ * @brief Сценарий теста.
+ */
+struct TestScenario
+{
+    const char *name;
+    bool (*run)();
+};
+
+/**
+ * @brief Выполнить сценарии и вывести результат каждого.
+ *
+ * @return Код возврата программы: 0, если все сценарии прошли.
+ */
+template <std::size_t N>
+int runScenarios(const TestScenario (&scenarios)[N])
+{
+    int failures = 0;
+    for (const TestScenario &scenario : scenarios)
+    {
+        const bool ok = scenario.run();
+        std::printf("%-28s %s\n", scenario.name, ok ? "ok" : "FAILED");
+        failures += ok ? 0 : 1;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+#endif // EEPROM_TEST_HPP
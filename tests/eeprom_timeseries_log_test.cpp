@@ -0,0 +1,452 @@
+#include "eeprom_test.hpp"
+#include "eeprom_timeseries_log.hpp"
+#include <cstring>
+
+/**
+ * @file eeprom_timeseries_log_test.cpp
+ * @brief Тест сжатого кольцевого журнала отсчётов EEPROMTimeSeriesLog.
+ */
+
+namespace
+{
+    using Sample = EEPROMTimeSeriesLog::Sample;
+
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+    constexpr std::size_t RING_PAGES = EEPROMTimeSeriesLog::MAX_PAGES;
+    constexpr std::size_t MAX_SAMPLES = RING_PAGES * EEPROMTimeSeriesLog::MAX_BLOCK_SAMPLES;
+
+    /**
+     * @brief Отсчёты, полученные из журнала.
+     */
+    struct Collected
+    {
+        Sample samples[MAX_SAMPLES];
+        std::size_t count;
+
+        static void onSample(const Sample &sample, void *context)
+        {
+            Collected &collected = *static_cast<Collected *>(context);
+            if (collected.count < MAX_SAMPLES)
+            {
+                collected.samples[collected.count] = sample;
+            }
+            ++collected.count;
+        }
+    };
+
+    /**
+     * @brief Журнал отдаёт ровно samples[0..count) по порядку.
+     */
+    bool holds(const EEPROMTimeSeriesLog &log, const Sample *samples, std::size_t count)
+    {
+        static Collected collected;
+        collected.count = 0;
+        if (log.forEach(Collected::onSample, &collected) != count || collected.count != count)
+        {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (collected.samples[i].timestamp != samples[i].timestamp ||
+                collected.samples[i].value != samples[i].value)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool checkRoundTrip()
+    {
+        // Все корзины кода времени и значения, включая переход через 2^32
+        const Sample samples[] = {
+            {1000, 0},          {1060, 0},          {1120, 0},          {1180, 3},
+            {1245, -1},         {1305, -60},        {1500, 63},         {1510, 64},
+            {3000, -32768},     {3001, 32767},      {3001, 32767},      {0x7FFFFFF0u, -5},
+            {0xFFFFFF00u, 100}, {0xFFFFFF3Cu, 100}, {0xFFFFFF78u, 101}, {0xFFFFFFB4u, -101},
+        };
+        const std::size_t count = sizeof(samples) / sizeof(samples[0]);
+
+        TestChip chip;
+        EEPROMTimeSeriesLog log(chip.eeprom, 0, RING_PAGES);
+        log.open();
+        for (const Sample &sample : samples)
+        {
+            if (!log.append(sample.timestamp, sample.value))
+            {
+                return false;
+            }
+        }
+
+        // Неполный блок в RAM виден до записи
+        if (!holds(log, samples, count) || !log.flush())
+        {
+            return false;
+        }
+
+        EEPROMTimeSeriesLog reopened(chip.eeprom, 0, RING_PAGES);
+        reopened.open();
+        return holds(reopened, samples, count);
+    }
+
+    bool checkPacksSamplesPerPage()
+    {
+        // Ровный шаг и постоянное значение: первый отсчёт - в заголовке,
+        // второй - 10 бит (интервал от нуля), остальные - по 2 бита
+        constexpr std::size_t PER_BLOCK = 2 + (EEPROMTimeSeriesLog::PAYLOAD_BITS - 10) / 2;
+        constexpr std::size_t BLOCKS = 3;
+        constexpr std::size_t COUNT = BLOCKS * PER_BLOCK;
+
+        TestChip chip;
+        EEPROMTimeSeriesLog log(chip.eeprom, 0, RING_PAGES);
+        log.open();
+
+        Sample samples[COUNT];
+        for (std::size_t i = 0; i < COUNT; ++i)
+        {
+            samples[i] = Sample{static_cast<uint32_t>(i * 60), 20};
+            log.append(samples[i].timestamp, samples[i].value);
+        }
+        log.flush();
+
+        EEPROMTimeSeriesLog reopened(chip.eeprom, 0, RING_PAGES);
+        reopened.open();
+        return chip.simulator.statistics().writeCycles == BLOCKS && holds(reopened, samples, COUNT);
+    }
+
+    bool checkFlushContinuesBlock()
+    {
+        TestChip chip;
+        EEPROMTimeSeriesLog log(chip.eeprom, 0, RING_PAGES);
+        log.open();
+
+        const Sample samples[] = {{10, 1}, {20, 2}, {30, 3}, {40, 4}, {50, 5}};
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            log.append(samples[i].timestamp, samples[i].value);
+        }
+        if (!log.flush() || log.flush())
+        {
+            return false;
+        }
+
+        // После повторного открытия блок продолжается на той же странице
+        EEPROMTimeSeriesLog reopened(chip.eeprom, 0, RING_PAGES);
+        reopened.open();
+        for (std::size_t i = 3; i < 5; ++i)
+        {
+            reopened.append(samples[i].timestamp, samples[i].value);
+        }
+        reopened.flush();
+
+        EEPROMTimeSeriesLog third(chip.eeprom, 0, RING_PAGES);
+        third.open();
+        return chip.simulator.statistics().writeCycles == 2 && chip.memory()[PAGE] == 0xFF &&
+               holds(third, samples, 5);
+    }
+
+    bool checkRingKeepsNewest()
+    {
+        // Кольцо из 4 страниц с 10-й: скачки значения закрывают блоки быстро
+        constexpr std::size_t FIRST = 10;
+        constexpr std::size_t PAGES = 4;
+        constexpr std::size_t COUNT = 200;
+
+        TestChip chip;
+        EEPROMTimeSeriesLog log(chip.eeprom, FIRST, PAGES);
+        log.open();
+
+        Sample samples[COUNT];
+        for (std::size_t i = 0; i < COUNT; ++i)
+        {
+            samples[i] = Sample{static_cast<uint32_t>(i * 60),
+                                static_cast<int16_t>((i * 7919) % 20001 - 10000)};
+            log.append(samples[i].timestamp, samples[i].value);
+        }
+        log.flush();
+
+        EEPROMTimeSeriesLog reopened(chip.eeprom, FIRST, PAGES);
+        reopened.open();
+        const std::size_t kept = reopened.forEach(nullptr, nullptr);
+        if (kept == 0 || kept >= COUNT || !holds(reopened, samples + COUNT - kept, kept))
+        {
+            return false;
+        }
+
+        // Страницы вне кольца не тронуты
+        for (std::size_t i = 0; i < CAPACITY; ++i)
+        {
+            const bool inside = i >= FIRST * PAGE && i < (FIRST + PAGES) * PAGE;
+            if (!inside && chip.memory()[i] != 0xFF)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool checkEmptyAndInvalidRing()
+    {
+        TestChip chip;
+
+        // Стёртая микросхема - пустой журнал
+        EEPROMTimeSeriesLog log(chip.eeprom, 0, RING_PAGES);
+        log.open();
+        if (log.forEach(nullptr, nullptr) != 0 || log.flush())
+        {
+            return false;
+        }
+
+        // Кольцо за пределами микросхемы не используется
+        EEPROMTimeSeriesLog outside(chip.eeprom, RING_PAGES - 2, 4);
+        outside.open();
+        return !outside.append(0, 1) && chip.simulator.statistics().writeCycles == 0;
+    }
+
+    /**
+     * @brief Журнал на всё кольцо с отсчётами через 60 с.
+     */
+    struct FilledLog
+    {
+        static constexpr std::size_t COUNT = 600;
+
+        TestChip chip;
+        Sample samples[COUNT];
+        std::size_t kept; ///< Сколько последних отсчётов осталось в кольце
+
+        FilledLog() : chip(), samples{}, kept(0)
+        {
+            EEPROMTimeSeriesLog log(chip.eeprom, 0, RING_PAGES);
+            log.open();
+
+            // Случайное блуждание: блоки разной длины
+            uint32_t seed = 1;
+            int value = 0;
+            for (std::size_t i = 0; i < COUNT; ++i)
+            {
+                seed = seed * 1103515245u + 12345u;
+                value += static_cast<int>((seed >> 16) % 41) - 20;
+                samples[i] = Sample{static_cast<uint32_t>(1000 + i * 60), static_cast<int16_t>(value)};
+                log.append(samples[i].timestamp, samples[i].value);
+            }
+            log.flush();
+            kept = log.forEach(nullptr, nullptr);
+        }
+
+        const Sample *oldest() const { return samples + COUNT - kept; }
+
+        /**
+         * @brief query() совпадает с перебором отсчётов.
+         */
+        bool queryMatches(const EEPROMTimeSeriesLog &log, uint32_t from, uint32_t to) const
+        {
+            static Collected collected;
+            collected.count = 0;
+            const std::size_t found = log.query(from, to, Collected::onSample, &collected);
+
+            std::size_t expected = 0;
+            for (std::size_t i = COUNT - kept; i < COUNT; ++i)
+            {
+                if (samples[i].timestamp < from || samples[i].timestamp > to)
+                {
+                    continue;
+                }
+                if (expected >= collected.count ||
+                    collected.samples[expected].timestamp != samples[i].timestamp ||
+                    collected.samples[expected].value != samples[i].value)
+                {
+                    return false;
+                }
+                ++expected;
+            }
+            return found == expected && collected.count == expected;
+        }
+
+        /**
+         * @brief summarize() совпадает с перебором отсчётов.
+         */
+        bool summaryMatches(const EEPROMTimeSeriesLog &log, uint32_t from, uint32_t to) const
+        {
+            EEPROMTimeSeriesLog::Summary expected{0, INT16_MAX, INT16_MIN};
+            for (std::size_t i = COUNT - kept; i < COUNT; ++i)
+            {
+                if (samples[i].timestamp >= from && samples[i].timestamp <= to)
+                {
+                    ++expected.count;
+                    expected.min = samples[i].value < expected.min ? samples[i].value : expected.min;
+                    expected.max = samples[i].value > expected.max ? samples[i].value : expected.max;
+                }
+            }
+
+            const EEPROMTimeSeriesLog::Summary summary = log.summarize(from, to);
+            return summary.count == expected.count &&
+                   (expected.count == 0 || (summary.min == expected.min && summary.max == expected.max));
+        }
+    };
+
+    bool checkOpenReadsRingOnce()
+    {
+        FilledLog filled;
+        filled.chip.eeprom.resetBusStatistics();
+
+        EEPROMTimeSeriesLog log(filled.chip.eeprom, 0, RING_PAGES);
+        log.open();
+        return filled.chip.eeprom.busStatistics().frames == 1 &&
+               filled.kept < FilledLog::COUNT && holds(log, filled.oldest(), filled.kept);
+    }
+
+    bool checkQueryMatchesScan()
+    {
+        FilledLog filled;
+        EEPROMTimeSeriesLog log(filled.chip.eeprom, 0, RING_PAGES);
+        log.open();
+
+        const uint32_t first = filled.oldest()->timestamp;
+        const uint32_t last = filled.samples[FilledLog::COUNT - 1].timestamp;
+        const uint32_t windows[][2] = {
+            {0, 0xFFFFFFFFu},
+            {first, first},
+            {first + 1, first + 59},
+            {first + 600, first + 3000},
+            {last - 1000, last},
+            {last, 0xFFFFFFFFu},
+        };
+        for (const auto &window : windows)
+        {
+            if (!filled.queryMatches(log, window[0], window[1]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool checkQueryReadsOverlapOnly()
+    {
+        FilledLog filled;
+        EEPROMTimeSeriesLog log(filled.chip.eeprom, 0, RING_PAGES);
+        log.open();
+
+        // Весь журнал: все блоки кольца, кроме текущего (он в RAM)
+        log.query(0, 0xFFFFFFFFu, nullptr, nullptr);
+        if (log.lastQueryPages() != RING_PAGES - 1)
+        {
+            return false;
+        }
+
+        // Один отсчёт: его блок и, если он первый в блоке, предыдущий
+        const uint32_t middle = filled.samples[FilledLog::COUNT - filled.kept / 2].timestamp;
+        if (log.query(middle, middle, nullptr, nullptr) != 1 || log.lastQueryPages() > 2)
+        {
+            return false;
+        }
+
+        // Затёртое время и пустой интервал не читают микросхему
+        filled.chip.eeprom.resetBusStatistics();
+        return log.query(0, filled.oldest()->timestamp - 1, nullptr, nullptr) == 0 &&
+               log.lastQueryPages() == 0 &&
+               log.query(middle, middle - 1, nullptr, nullptr) == 0 && log.lastQueryPages() == 0 &&
+               filled.chip.eeprom.busStatistics().frames == 0;
+    }
+
+    bool checkIndexFollowsAppend()
+    {
+        FilledLog filled;
+        EEPROMTimeSeriesLog log(filled.chip.eeprom, 0, RING_PAGES);
+        log.open();
+
+        // Новые отсчёты без записи на микросхему находятся по индексу
+        const uint32_t next = filled.samples[FilledLog::COUNT - 1].timestamp + 60;
+        log.append(next, 7);
+        log.append(next + 60, 8);
+        filled.chip.eeprom.resetBusStatistics();
+        if (log.query(next + 60, next + 60, nullptr, nullptr) != 1 || log.lastQueryPages() != 0 ||
+            filled.chip.eeprom.busStatistics().frames != 0)
+        {
+            return false;
+        }
+        return log.query(next, 0xFFFFFFFFu, nullptr, nullptr) == 2;
+    }
+
+    bool checkSummaryMatchesScan()
+    {
+        FilledLog filled;
+        EEPROMTimeSeriesLog log(filled.chip.eeprom, 0, RING_PAGES);
+        log.open();
+
+        const uint32_t first = filled.oldest()->timestamp;
+        const uint32_t last = filled.samples[FilledLog::COUNT - 1].timestamp;
+        for (uint32_t from = first - 60; from <= last; from += 1170)
+        {
+            for (uint32_t length = 0; length <= 9000; length += 1530)
+            {
+                if (!filled.summaryMatches(log, from, from + length))
+                {
+                    return false;
+                }
+            }
+        }
+        return filled.summaryMatches(log, 0, 0xFFFFFFFFu) && filled.summaryMatches(log, last, last - 1);
+    }
+
+    bool checkSummaryReadsBoundaries()
+    {
+        FilledLog filled;
+        EEPROMTimeSeriesLog log(filled.chip.eeprom, 0, RING_PAGES);
+        log.open();
+
+        // Весь журнал - только по индексу
+        filled.chip.eeprom.resetBusStatistics();
+        if (log.summarize(0, 0xFFFFFFFFu).count != filled.kept || log.lastQueryPages() != 0 ||
+            filled.chip.eeprom.busStatistics().frames != 0)
+        {
+            return false;
+        }
+
+        // Интервал с границами внутри блоков - не больше двух страниц
+        const uint32_t from = filled.oldest()[filled.kept / 4].timestamp + 1;
+        const uint32_t to = filled.oldest()[filled.kept * 3 / 4].timestamp - 1;
+        filled.chip.eeprom.resetBusStatistics();
+        log.summarize(from, to);
+        return log.lastQueryPages() <= 2 && filled.chip.eeprom.busStatistics().frames <= 2;
+    }
+
+    bool checkSummaryFollowsAppend()
+    {
+        FilledLog filled;
+        EEPROMTimeSeriesLog log(filled.chip.eeprom, 0, RING_PAGES);
+        log.open();
+
+        // Сводка текущего блока обновляется при добавлении (новый блок
+        // может затереть самый старый, поэтому количество - по forEach())
+        const uint32_t next = filled.samples[FilledLog::COUNT - 1].timestamp + 60;
+        log.append(next, -30000);
+        log.append(next + 60, 30000);
+        const EEPROMTimeSeriesLog::Summary summary = log.summarize(0, 0xFFFFFFFFu);
+        const EEPROMTimeSeriesLog::Summary tail = log.summarize(next, next + 60);
+        return summary.count == log.forEach(nullptr, nullptr) && summary.min == -30000 && summary.max == 30000 &&
+               tail.count == 2 && tail.min == -30000 && tail.max == 30000;
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"round_trip", checkRoundTrip},
+        {"packs_samples_per_page", checkPacksSamplesPerPage},
+        {"flush_continues_block", checkFlushContinuesBlock},
+        {"ring_keeps_newest", checkRingKeepsNewest},
+        {"empty_and_invalid_ring", checkEmptyAndInvalidRing},
+        {"open_reads_ring_once", checkOpenReadsRingOnce},
+        {"query_matches_scan", checkQueryMatchesScan},
+        {"query_reads_overlap_only", checkQueryReadsOverlapOnly},
+        {"index_follows_append", checkIndexFollowsAppend},
+        {"summary_matches_scan", checkSummaryMatchesScan},
+        {"summary_reads_boundaries", checkSummaryReadsBoundaries},
+        {"summary_follows_append", checkSummaryFollowsAppend},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
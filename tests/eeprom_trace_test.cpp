@@ -0,0 +1,137 @@
+#include "eeprom_test.hpp"
+#include "eeprom_trace.hpp"
+#include <cstring>
+
+/**
+ * @file eeprom_trace_test.cpp
+ * @brief Тест записи и воспроизведения трасс EEPROMTraceRecorder / replayTrace().
+ */
+
+namespace
+{
+    /**
+     * @brief Набор операций, по которому строится трасса.
+     */
+    void runWorkload(EEPROM25LC040A &eeprom)
+    {
+        uint8_t data[40];
+        fillPattern(data, sizeof(data), 3);
+
+        eeprom.writeByte(5, 0x42);
+        eeprom.writeArray(10, data, sizeof(data));
+        eeprom.readArray(10, data, sizeof(data));
+        eeprom.writeBits(100, 3, 4, 0x0A);
+        eeprom.readByte(5);
+    }
+
+    bool checkRecordsOperations()
+    {
+        TestChip chip;
+        testClockSource = &chip.simulator;
+
+        uint8_t trace[256];
+        EEPROMTraceRecorder recorder(trace, sizeof(trace), testClock);
+        chip.eeprom.addListener(&recorder);
+        runWorkload(chip.eeprom);
+
+        const EEPROMOperationInfo expected[] = {
+            {EEPROMOperation::WRITE_BYTE, 5, 1, 0},
+            {EEPROMOperation::WRITE_ARRAY, 10, 40, 0},
+            {EEPROMOperation::READ_ARRAY, 10, 40, 0},
+            {EEPROMOperation::WRITE_BITS, 100, 4, 3},
+            {EEPROMOperation::READ_BYTE, 5, 1, 0},
+        };
+
+        EEPROMTraceReader reader(recorder.data(), recorder.size());
+        EEPROMTraceRecord record{};
+        uint64_t previous = 0;
+        for (const EEPROMOperationInfo &info : expected)
+        {
+            if (!reader.next(record) || record.info.op != info.op ||
+                record.info.address != info.address || record.info.length != info.length ||
+                record.info.bitOffset != info.bitOffset || record.timestampUs < previous)
+            {
+                return false;
+            }
+            previous = record.timestampUs;
+        }
+
+        if (recorder.overflowed() || reader.next(record))
+        {
+            return false;
+        }
+
+        // Запись массива в четыре страницы длится не меньше трёх tWC
+        reader.rewind();
+        EEPROMTraceRecord first{};
+        EEPROMTraceRecord second{};
+        EEPROMTraceRecord third{};
+        return reader.next(first) && reader.next(second) && reader.next(third) &&
+               third.timestampUs - second.timestampUs >= 3 * 5000;
+    }
+
+    bool checkOverflowKeepsPrefix()
+    {
+        TestChip chip;
+
+        // Заголовок и две записи по 4 байта
+        uint8_t trace[12];
+        EEPROMTraceRecorder recorder(trace, sizeof(trace), nullptr);
+        chip.eeprom.addListener(&recorder);
+        runWorkload(chip.eeprom);
+
+        EEPROMTraceReader reader(recorder.data(), recorder.size());
+        EEPROMTraceRecord record{};
+        std::size_t count = 0;
+        while (reader.next(record))
+        {
+            ++count;
+        }
+
+        return recorder.overflowed() && reader.valid() && count == 2;
+    }
+
+    bool checkReplayReproducesBusLoad()
+    {
+        TestChip original;
+        testClockSource = &original.simulator;
+
+        uint8_t trace[256];
+        EEPROMTraceRecorder recorder(trace, sizeof(trace), testClock);
+        original.eeprom.addListener(&recorder);
+        runWorkload(original.eeprom);
+
+        TestChip replica;
+        EEPROMTraceReader reader(recorder.data(), recorder.size());
+        const EEPROM25LC040ASimulator::Statistics &a = original.simulator.statistics();
+        const EEPROM25LC040ASimulator::Statistics &b = replica.simulator.statistics();
+        return replayTrace(reader, replica.eeprom) == 5 &&
+               a.writeCycles == b.writeCycles && a.frames == b.frames && a.clocks == b.clocks;
+    }
+
+    bool checkRejectsDamagedTrace()
+    {
+        const uint8_t foreign[] = {'E', 'T', 'R', '0', 0x01, 0x05, 0x01, 0x00};
+        EEPROMTraceReader bad_magic(foreign, sizeof(foreign));
+
+        // Последнее LEB128-число обрезано
+        const uint8_t truncated[] = {'E', 'T', 'R', '1', 0x01, 0x05, 0x01, 0x80};
+        EEPROMTraceReader cut(truncated, sizeof(truncated));
+        EEPROMTraceRecord record{};
+
+        return !bad_magic.valid() && !bad_magic.next(record) &&
+               cut.valid() && !cut.next(record) && !cut.valid();
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"records_operations", checkRecordsOperations},
+        {"overflow_keeps_prefix", checkOverflowKeepsPrefix},
+        {"replay_reproduces_bus_load", checkReplayReproducesBusLoad},
+        {"rejects_damaged_trace", checkRejectsDamagedTrace},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
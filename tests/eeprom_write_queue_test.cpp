@@ -0,0 +1,144 @@
+#include "eeprom_test.hpp"
+#include "eeprom_write_queue.hpp"
+#include <cstring>
+#include <thread>
+
+/**
+ * @file eeprom_write_queue_test.cpp
+ * @brief Тест очереди запросов записи EEPROMWriteQueue.
+ */
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+
+    bool checkCoalescesPage()
+    {
+        TestChip chip;
+        EEPROMWriteQueue<8> queue;
+        const uint8_t first[4] = {1, 2, 3, 4};
+        const uint8_t second[4] = {5, 6, 7, 8};
+        if (!queue.tryPush(2 * PAGE, first, sizeof(first)) ||
+            !queue.tryPush(2 * PAGE + 4, second, sizeof(second)))
+        {
+            return false;
+        }
+
+        // Два запроса к одной странице - один цикл записи
+        return queue.drain(chip.eeprom) == 2 && queue.empty() &&
+               chip.simulator.statistics().writeCycles == 1 &&
+               std::memcmp(chip.memory() + 2 * PAGE, first, sizeof(first)) == 0 &&
+               std::memcmp(chip.memory() + 2 * PAGE + 4, second, sizeof(second)) == 0;
+    }
+
+    bool checkGapKeepsChipBytes()
+    {
+        TestChip chip;
+        fillPattern(chip.simulator.memory(), CAPACITY, 5);
+        uint8_t before[CAPACITY];
+        std::memcpy(before, chip.memory(), CAPACITY);
+
+        EEPROMWriteQueue<8> queue;
+        const uint8_t value[2] = {0xA1, 0xA2};
+        queue.tryPush(3 * PAGE + 1, value, sizeof(value));
+        queue.tryPush(3 * PAGE + 10, value, sizeof(value));
+        queue.drain(chip.eeprom);
+
+        // Байты между запросами дочитаны с микросхемы и записаны без изменений
+        std::memcpy(before + 3 * PAGE + 1, value, sizeof(value));
+        std::memcpy(before + 3 * PAGE + 10, value, sizeof(value));
+        return chip.simulator.statistics().writeCycles == 1 &&
+               std::memcmp(chip.memory(), before, CAPACITY) == 0;
+    }
+
+    bool checkRequestAcrossPages()
+    {
+        TestChip chip;
+        EEPROMWriteQueue<4> queue;
+        uint8_t data[PAGE];
+        fillPattern(data, sizeof(data), 9);
+
+        return queue.tryPush(PAGE + 8, data, sizeof(data)) && queue.drain(chip.eeprom) == 1 &&
+               chip.simulator.statistics().writeCycles == 2 &&
+               std::memcmp(chip.memory() + PAGE + 8, data, sizeof(data)) == 0;
+    }
+
+    bool checkRejectsWhenFull()
+    {
+        EEPROMWriteQueue<4, 8> queue;
+        const uint8_t data[9] = {};
+
+        // Некорректные запросы
+        if (queue.tryPush(0, nullptr, 1) || queue.tryPush(0, data, 0) ||
+            queue.tryPush(0, data, 9) || queue.tryPush(CAPACITY - 2, data, 4))
+        {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            if (!queue.tryPush(i * PAGE, data, 1))
+            {
+                return false;
+            }
+        }
+        if (queue.tryPush(0, data, 1))
+        {
+            return false;
+        }
+
+        // После выполнения слоты свободны
+        TestChip chip;
+        return queue.drain(chip.eeprom) == 4 && queue.tryPush(0, data, 1);
+    }
+
+    bool checkConcurrentProducer()
+    {
+        // Производитель в отдельном потоке, потребитель выполняет запросы по мере поступления
+        constexpr std::size_t REQUESTS = 200;
+        TestChip chip;
+        EEPROMWriteQueue<8> queue;
+
+        std::thread producer([&queue]()
+                             {
+                                 for (std::size_t i = 0; i < REQUESTS; ++i)
+                                 {
+                                     const uint8_t value = static_cast<uint8_t>(i);
+                                     while (!queue.tryPush(i % CAPACITY, &value, 1))
+                                     {
+                                         std::this_thread::yield();
+                                     }
+                                 } });
+
+        std::size_t done = 0;
+        while (done < REQUESTS)
+        {
+            done += queue.drain(chip.eeprom);
+        }
+        producer.join();
+
+        // Каждый адрес содержит последнее записанное в него значение
+        for (std::size_t address = 0; address < REQUESTS && address < CAPACITY; ++address)
+        {
+            if (chip.memory()[address] != static_cast<uint8_t>(address))
+            {
+                return false;
+            }
+        }
+        return queue.empty();
+    }
+
+    const TestScenario SCENARIOS[] = {
+        {"coalesces_page", checkCoalescesPage},
+        {"gap_keeps_chip_bytes", checkGapKeepsChipBytes},
+        {"request_across_pages", checkRequestAcrossPages},
+        {"rejects_when_full", checkRejectsWhenFull},
+        {"concurrent_producer", checkConcurrentProducer},
+    };
+}
+
+int main()
+{
+    return runScenarios(SCENARIOS);
+}
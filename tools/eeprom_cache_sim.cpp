@@ -0,0 +1,105 @@
+#include "eeprom_cache_model.hpp"
+#include "eeprom_trace.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+/**
+ * @file eeprom_cache_sim.cpp
+ * @brief Утилита сравнения политик кеширования по записанной трассе.
+ *
+ * Использование:
+ * @code
+ * eeprom_cache_sim <trace.bin> [clock_period_ns] [write_cycle_us]
+ * @endcode
+ *
+ * Прогоняет трассу через набор конфигураций (без кеша, полное
+ * зеркало со сквозной и отложенной записью, LRU разных размеров
+ * с упреждающим чтением) и выводит таблицу результатов.
+ */
+
+namespace
+{
+    using Policy = EEPROMCacheConfig::Policy;
+
+    struct Candidate
+    {
+        const char *name;
+        Policy policy;
+        std::size_t lruPages;
+        std::size_t readaheadPages;
+        uint32_t flushIntervalUs;
+    };
+
+    const Candidate CANDIDATES[] = {
+        {"none", Policy::NONE, 0, 0, 0},
+        {"mirror/wt", Policy::FULL_MIRROR, 0, 0, 0},
+        {"mirror/wb-10ms", Policy::FULL_MIRROR, 0, 0, 10000},
+        {"mirror/wb-100ms", Policy::FULL_MIRROR, 0, 0, 100000},
+        {"mirror/wb-1s", Policy::FULL_MIRROR, 0, 0, 1000000},
+        {"lru4/ra0/wt", Policy::LRU, 4, 0, 0},
+        {"lru4/ra1/wb-100ms", Policy::LRU, 4, 1, 100000},
+        {"lru8/ra0/wb-100ms", Policy::LRU, 8, 0, 100000},
+        {"lru8/ra2/wb-100ms", Policy::LRU, 8, 2, 100000},
+        {"lru16/ra2/wb-100ms", Policy::LRU, 16, 2, 100000},
+    };
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || argc > 4)
+    {
+        std::cerr << "usage: " << argv[0] << " <trace.bin> [clock_period_ns] [write_cycle_us]\n";
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in)
+    {
+        std::cerr << "cannot read trace " << argv[1] << "\n";
+        return 1;
+    }
+    const std::vector<uint8_t> trace((std::istreambuf_iterator<char>(in)),
+                                     std::istreambuf_iterator<char>());
+
+    EEPROMTraceReader reader(trace.data(), trace.size());
+    if (!reader.valid())
+    {
+        std::cerr << "not a trace file: " << argv[1] << "\n";
+        return 1;
+    }
+
+    const unsigned clock_period_ns = (argc > 2) ? static_cast<unsigned>(std::stoul(argv[2])) : 1000;
+    const unsigned write_cycle_us = (argc > 3) ? static_cast<unsigned>(std::stoul(argv[3])) : 5000;
+
+    std::printf("%-20s %8s %10s %8s %8s %8s %12s %12s\n",
+                "config", "ops", "bus_bytes", "frames", "tWC", "hits", "bus_us", "foreground_us");
+
+    for (const Candidate &candidate : CANDIDATES)
+    {
+        const EEPROMCacheConfig config{candidate.policy,
+                                       candidate.lruPages,
+                                       candidate.readaheadPages,
+                                       candidate.flushIntervalUs,
+                                       clock_period_ns,
+                                       write_cycle_us};
+
+        reader.rewind();
+        EEPROMCacheModel model(config);
+        const EEPROMCacheReport report = model.run(reader);
+
+        std::printf("%-20s %8llu %10llu %8llu %8llu %8llu %12llu %12llu\n",
+                    candidate.name,
+                    static_cast<unsigned long long>(report.operations),
+                    static_cast<unsigned long long>(report.busBytes),
+                    static_cast<unsigned long long>(report.busTransactions),
+                    static_cast<unsigned long long>(report.writeCycles),
+                    static_cast<unsigned long long>(report.cacheHits),
+                    static_cast<unsigned long long>(report.busTimeUs),
+                    static_cast<unsigned long long>(report.foregroundUs));
+    }
+
+    return 0;
+}
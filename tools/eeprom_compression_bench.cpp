@@ -0,0 +1,168 @@
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_25lc040a_simulator.hpp"
+#include "eeprom_compression.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @file eeprom_compression_bench.cpp
+ * @brief Сравнение сжатых и обычных записей на симуляторе 25LC040A.
+ *
+ * Использование:
+ * @code
+ * eeprom_compression_bench [record_size] [clock_period_ns] [write_cycle_us]
+ * @endcode
+ *
+ * Для нескольких типичных видов записей сохраняет одну и ту же
+ * запись через writeArray и через writeCompressedRecord, проверяет
+ * чтение и выводит размер, число программирований страниц и
+ * модельное время записи и чтения.
+ */
+
+namespace
+{
+    constexpr std::size_t MAX_RECORD = EEPROM25LC040A::CAPACITY_BYTES - LZ_RECORD_HEADER;
+
+    struct Sample
+    {
+        const char *name;
+        void (*fill)(uint8_t *data, std::size_t length);
+    };
+
+    void fillZeros(uint8_t *data, std::size_t length)
+    {
+        std::memset(data, 0, length);
+        // Немного ненулевых полей, как у реальной конфигурации
+        for (std::size_t i = 0; i < length; i += 37)
+        {
+            data[i] = static_cast<uint8_t>(i);
+        }
+    }
+
+    void fillDeltas(uint8_t *data, std::size_t length)
+    {
+        // Медленно меняющиеся 16-битные отсчёты
+        unsigned value = 1000;
+        for (std::size_t i = 0; i + 1 < length; i += 2)
+        {
+            value += static_cast<unsigned>(std::rand() % 3);
+            data[i] = static_cast<uint8_t>(value & 0xFF);
+            data[i + 1] = static_cast<uint8_t>(value >> 8);
+        }
+        if (length % 2 != 0)
+        {
+            data[length - 1] = 0;
+        }
+    }
+
+    void fillRepeated(uint8_t *data, std::size_t length)
+    {
+        // Массив одинаковых структур по 12 байт
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            data[i] = static_cast<uint8_t>((i % 12) * 17 + (i / 96));
+        }
+    }
+
+    void fillRandom(uint8_t *data, std::size_t length)
+    {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            data[i] = static_cast<uint8_t>(std::rand());
+        }
+    }
+
+    const Sample SAMPLES[] = {
+        {"sparse-zeros", fillZeros},
+        {"small-deltas", fillDeltas},
+        {"repeated-struct", fillRepeated},
+        {"random", fillRandom},
+    };
+
+    struct Result
+    {
+        std::size_t bytes;
+        uint64_t writeCycles;
+        uint64_t writeUs;
+        uint64_t readUs;
+        bool ok;
+    };
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 4)
+    {
+        std::fprintf(stderr, "usage: %s [record_size] [clock_period_ns] [write_cycle_us]\n", argv[0]);
+        return 1;
+    }
+
+    const std::size_t size = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 256;
+    const unsigned clock_ns = (argc > 2) ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 1000;
+    const unsigned cycle_us = (argc > 3) ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 5000;
+
+    if (size == 0 || size > MAX_RECORD)
+    {
+        std::fprintf(stderr, "record_size must be in [1, %zu]\n", MAX_RECORD);
+        return 1;
+    }
+
+    std::srand(1);
+
+    std::printf("%-16s %-6s %6s %7s %10s %10s %s\n",
+                "record", "format", "bytes", "pages", "write_us", "read_us", "check");
+
+    for (const Sample &sample : SAMPLES)
+    {
+        uint8_t record[MAX_RECORD];
+        sample.fill(record, size);
+
+        for (int compressed = 0; compressed < 2; ++compressed)
+        {
+            EEPROM25LC040ASimulator simulator(clock_ns, cycle_us);
+            SPIBitBangingHelper helper(simulator);
+            EEPROM25LC040A eeprom(helper);
+
+            Result result{};
+            uint64_t start = simulator.elapsedNs();
+            if (compressed)
+            {
+                result.bytes = writeCompressedRecord(eeprom, 0, record,
+                                                     size, EEPROM25LC040A::CAPACITY_BYTES);
+            }
+            else
+            {
+                eeprom.writeArray(0, record, size);
+                result.bytes = size;
+            }
+            result.writeUs = (simulator.elapsedNs() - start) / 1000;
+            result.writeCycles = simulator.statistics().writeCycles;
+
+            uint8_t back[MAX_RECORD];
+            start = simulator.elapsedNs();
+            if (compressed)
+            {
+                result.ok = readCompressedRecord(eeprom, 0, back, sizeof(back)) == size;
+            }
+            else
+            {
+                eeprom.readArray(0, back, size);
+                result.ok = true;
+            }
+            result.readUs = (simulator.elapsedNs() - start) / 1000;
+            result.ok = result.ok && std::memcmp(back, record, size) == 0;
+
+            std::printf("%-16s %-6s %6zu %7llu %10llu %10llu %s\n",
+                        sample.name,
+                        compressed ? "lzss" : "plain",
+                        result.bytes,
+                        static_cast<unsigned long long>(result.writeCycles),
+                        static_cast<unsigned long long>(result.writeUs),
+                        static_cast<unsigned long long>(result.readUs),
+                        result.ok ? "ok" : "FAILED");
+        }
+    }
+
+    return 0;
+}
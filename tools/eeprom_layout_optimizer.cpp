@@ -0,0 +1,152 @@
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_layout_optimizer.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @file eeprom_layout_optimizer.cpp
+ * @brief Утилита оптимизации размещения полей по трассе записей.
+ *
+ * Использование:
+ * @code
+ * eeprom_layout_optimizer <layout> <trace> [region_start region_size]
+ * @endcode
+ *
+ * Формат раскладки (строки, # - комментарий):
+ * @code
+ * <id> <address> <size>
+ * @endcode
+ *
+ * Формат трассы:
+ * @code
+ * W <address> <length>   - запись
+ * S                      - конец пакета обновлений (sync)
+ * @endcode
+ *
+ * На stdout выводится новая раскладка в том же формате
+ * и план миграции (строки "# move <id> <from> <to> <size>").
+ */
+
+namespace
+{
+    bool readLayout(const char *path, std::vector<FieldPlacement> &layout)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            std::istringstream fields(line);
+            unsigned id = 0;
+            std::size_t address = 0;
+            std::size_t size = 0;
+            if (fields >> id >> address >> size)
+            {
+                layout.push_back(FieldPlacement{static_cast<uint16_t>(id), address, size});
+            }
+        }
+
+        return true;
+    }
+
+    bool readTrace(const char *path, FieldLayoutOptimizer &optimizer)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(in, line))
+        {
+            std::istringstream fields(line);
+            std::string op;
+            if (!(fields >> op))
+            {
+                continue;
+            }
+
+            std::size_t address = 0;
+            std::size_t length = 0;
+            if (op == "W" && (fields >> address >> length))
+            {
+                optimizer.addWrite(address, length);
+            }
+            else if (op == "S")
+            {
+                optimizer.endBatch();
+            }
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3 && argc != 5)
+    {
+        std::cerr << "usage: " << argv[0] << " <layout> <trace> [region_start region_size]\n";
+        return 1;
+    }
+
+    std::vector<FieldPlacement> layout;
+    if (!readLayout(argv[1], layout))
+    {
+        std::cerr << "cannot read layout " << argv[1] << "\n";
+        return 1;
+    }
+
+    if (!FieldLayoutOptimizer::validLayout(layout))
+    {
+        std::cerr << "layout has empty fields or fields past the end of the chip\n";
+        return 1;
+    }
+
+    const std::size_t region_start = (argc == 5) ? std::strtoul(argv[3], nullptr, 0) : 0;
+    const std::size_t region_size = (argc == 5) ? std::strtoul(argv[4], nullptr, 0)
+                                                : EEPROM25LC040A::CAPACITY_BYTES;
+
+    FieldLayoutOptimizer optimizer(layout.data(), layout.size(), region_start, region_size);
+    if (!readTrace(argv[2], optimizer))
+    {
+        std::cerr << "cannot read trace " << argv[2] << "\n";
+        return 1;
+    }
+
+    if (!optimizer.optimize())
+    {
+        std::cerr << "fields do not fit into the region\n";
+        return 1;
+    }
+
+    std::cout << "# page programs: " << optimizer.pagePrograms(optimizer.currentLayout())
+              << " -> " << optimizer.pagePrograms(optimizer.layout()) << "\n";
+
+    for (const FieldPlacement &field : optimizer.layout())
+    {
+        std::cout << field.id << " " << field.address << " " << field.size << "\n";
+    }
+
+    for (const FieldMove &move : optimizer.migrationPlan())
+    {
+        std::cout << "# move " << move.id << " " << move.from << " " << move.to
+                  << " " << move.size << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_patch.hpp"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+/**
+ * @file eeprom_make_patch.cpp
+ * @brief Утилита построения патча между двумя образами EEPROM.
+ *
+ * Использование:
+ * @code
+ * eeprom_make_patch <base.bin> <target.bin> <patch.bin>
+ * @endcode
+ *
+ * Образы - файлы по CAPACITY_BYTES байт. Выводит размер патча,
+ * количество участков и количество страниц, которые будут запрограммированы.
+ */
+
+namespace
+{
+    bool readImage(const char *path, std::vector<uint8_t> &image)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            return false;
+        }
+        image.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return image.size() == EEPROM25LC040A::CAPACITY_BYTES;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4)
+    {
+        std::cerr << "usage: " << argv[0] << " <base.bin> <target.bin> <patch.bin>\n";
+        return 1;
+    }
+
+    std::vector<uint8_t> base;
+    std::vector<uint8_t> target;
+    if (!readImage(argv[1], base) || !readImage(argv[2], target))
+    {
+        std::cerr << "images must be " << EEPROM25LC040A::CAPACITY_BYTES << " bytes\n";
+        return 1;
+    }
+
+    // Худший случай: один участок на весь образ
+    std::vector<uint8_t> patch(PATCH_HEADER_SIZE + PATCH_RUN_HEADER_SIZE +
+                               EEPROM25LC040A::CAPACITY_BYTES);
+    const std::size_t size = makePatch(base.data(), target.data(), patch.data(), patch.size());
+    if (size == 0)
+    {
+        std::cerr << "cannot build patch\n";
+        return 1;
+    }
+
+    std::ofstream out(argv[3], std::ios::binary);
+    out.write(reinterpret_cast<const char *>(patch.data()), static_cast<std::streamsize>(size));
+    if (!out)
+    {
+        std::cerr << "cannot write " << argv[3] << "\n";
+        return 1;
+    }
+
+    std::size_t pages = 0;
+    for (std::size_t page = 0; page < EEPROM25LC040A::CAPACITY_BYTES / EEPROM25LC040A::PAGE_SIZE; ++page)
+    {
+        for (std::size_t i = 0; i < EEPROM25LC040A::PAGE_SIZE; ++i)
+        {
+            const std::size_t address = page * EEPROM25LC040A::PAGE_SIZE + i;
+            if (base[address] != target[address])
+            {
+                ++pages;
+                break;
+            }
+        }
+    }
+
+    std::cout << "patch_bytes " << size << "\n"
+              << "runs        " << (patch[12] | (patch[13] << 8)) << "\n"
+              << "pages       " << pages << "\n";
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_25lc040a_simulator.hpp"
+#include "eeprom_compression.hpp"
+#include "eeprom_layout_migration.hpp"
+#include "eeprom_metrics.hpp"
+#include "eeprom_page_hash_tree.hpp"
+#include "eeprom_patch.hpp"
+#include "eeprom_profiler.hpp"
+#include "eeprom_shadow.hpp"
+#include "eeprom_slow_log.hpp"
+#include "eeprom_timeseries_log.hpp"
+#include "eeprom_trace.hpp"
+#include "eeprom_write_queue.hpp"
+#include "spi_bit_banging_helper.hpp"
+#include <cstdio>
+#include <cstring>
+
+/**
+ * @file eeprom_no_heap_check.cpp
+ * @brief Проверка библиотеки eeprom без динамической памяти.
+ *
+ * Собирается вместе с eeprom_no_heap.cpp: любое обращение к operator new
+ * аварийно завершает программу. Программа создаёт каждый класс
+ * библиотеки eeprom на симуляторе 25LC040A и вызывает его основные
+ * методы, поэтому выделение памяти в пути устройства видно как
+ * аварийное завершение, а зависимость от распределителя - как ошибка
+ * компоновки. Результаты вызовов не сверяются: поведение проверяют
+ * тесты в tests/.
+ *
+ * Запускается через ctest (цель eeprom_no_heap_check).
+ */
+
+namespace
+{
+    constexpr std::size_t PAGE = EEPROM25LC040A::PAGE_SIZE;
+    constexpr std::size_t CAPACITY = EEPROM25LC040A::CAPACITY_BYTES;
+
+    const EEPROM25LC040ASimulator *clockSource = nullptr;
+
+    /**
+     * @brief Модельное время симулятора в микросекундах.
+     */
+    uint32_t simulatorClock()
+    {
+        return static_cast<uint32_t>(clockSource->elapsedNs() / 1000);
+    }
+
+    /**
+     * @brief Микросхема на симуляторе.
+     */
+    struct Chip
+    {
+        EEPROM25LC040ASimulator simulator;
+        SPIBitBangingHelper spi;
+        EEPROM25LC040A eeprom;
+
+        Chip() : simulator(), spi(simulator), eeprom(spi) {}
+    };
+
+    void useDriver(Chip &chip, Chip &other)
+    {
+        uint8_t data[2 * PAGE] = {1, 2, 3};
+        chip.eeprom.writeByte(0, 1);
+        chip.eeprom.readByte(0);
+        chip.eeprom.writeArray(PAGE - 3, data, sizeof(data));
+        chip.eeprom.readArray(0, data, sizeof(data));
+        chip.eeprom.writeBits(3, 2, 5, 0x15);
+        chip.eeprom.readBits(3, 2, 5);
+
+        const EEPROM25LC040A::BitField fields[] = {{4, 0, 12}, {5, 12, 9}};
+        uint32_t values[] = {0x123, 0x45};
+        chip.eeprom.writeFields(fields, 2, values);
+        chip.eeprom.readFields(fields, 2, values);
+
+        CancellationToken token;
+        chip.eeprom.readArray(0, data, sizeof(data), token);
+        chip.eeprom.writeArray(0, data, sizeof(data), token);
+        chip.eeprom.verifyArray(0, data, sizeof(data), &token);
+        EEPROM25LC040A::copyBetween(chip.eeprom, 0, other.eeprom, 0, sizeof(data));
+        EEPROM25LC040A::copyBetween(chip.eeprom, 0, chip.eeprom, 8, sizeof(data));
+    }
+
+    void onChange(std::size_t, std::size_t, void *)
+    {
+    }
+
+    void useShadow(Chip &chip)
+    {
+        EEPROMShadow shadow(chip.eeprom);
+        shadow.load();
+        shadow.setFlushDelay(simulatorClock, 1000);
+        const int id = shadow.subscribe(0, PAGE, onChange);
+
+        const uint8_t value = 0x5A;
+        shadow.write(0, &value, 1, EEPROMShadow::Durability::BUFFERED);
+        shadow.barrier();
+        shadow.write(PAGE, &value, 1, EEPROMShadow::Durability::DURABLE);
+        shadow.poll();
+        shadow.data()[2 * PAGE] = value;
+        shadow.sync();
+        shadow.unsubscribe(id);
+
+        shadow.enableCoherencyTable(CAPACITY - EEPROMShadow::PAGE_COUNT);
+        shadow.checkCoherency();
+    }
+
+    void useHashTree(Chip &chip)
+    {
+        EEPROMPageHashTree tree(chip.eeprom, 0, 8, 16 * PAGE);
+        const uint8_t data[4] = {1, 2, 3, 4};
+        tree.build();
+        tree.write(10, data, sizeof(data));
+        tree.load();
+        tree.verify(0, 8 * PAGE);
+    }
+
+    void useLayoutMigration(Chip &chip)
+    {
+        const FieldPlacement oldLayout[] = {{1, 0, 4}, {2, PAGE, 4}};
+        const FieldPlacement newLayout[] = {{1, PAGE, 4}, {2, 0, 4}};
+        EEPROMLayoutMigration migration(chip.eeprom, oldLayout, 2, newLayout, 2, 24 * PAGE);
+        migration.plan();
+        migration.run();
+    }
+
+    void useRecordsAndPatches(Chip &chip)
+    {
+        uint8_t base[CAPACITY] = {};
+        uint8_t target[CAPACITY];
+        writeCompressedRecord(chip.eeprom, 0, base, 256, CAPACITY);
+        readCompressedRecord(chip.eeprom, 0, target, 256);
+
+        chip.eeprom.readArray(0, base, CAPACITY);
+        std::memcpy(target, base, CAPACITY);
+        target[5] ^= 0xFF;
+        uint8_t patch[CAPACITY];
+        applyPatch(chip.eeprom, patch, makePatch(base, target, patch, sizeof(patch)));
+    }
+
+    void useTimeSeries(Chip &chip)
+    {
+        EEPROMTimeSeriesLog log(chip.eeprom, 0, 8);
+        log.open();
+        for (uint32_t i = 0; i < 40; ++i)
+        {
+            log.append(i * 60, static_cast<int16_t>(i * 13));
+        }
+        log.flush();
+        log.forEach(nullptr, nullptr);
+        log.query(600, 1200, nullptr, nullptr);
+        log.summarize(0, 2400);
+    }
+
+    void useListeners(Chip &chip)
+    {
+        static uint8_t traceBuffer[1024];
+        EEPROMTraceRecorder recorder(traceBuffer, sizeof(traceBuffer), simulatorClock);
+        EEPROMCallSiteProfiler profiler(chip.eeprom, simulatorClock);
+        EEPROMSlowOperationLog<4> slowLog(chip.eeprom, simulatorClock, 1000);
+        EEPROMMetrics metrics(chip.eeprom, simulatorClock);
+        chip.eeprom.addListener(&recorder);
+        chip.eeprom.addListener(&profiler);
+        chip.eeprom.addListener(&slowLog);
+        chip.eeprom.addListener(&metrics);
+
+        {
+            EEPROM_PROFILE_FUNCTION(profiler);
+            chip.eeprom.writeByte(5, 0x42);
+            chip.eeprom.readByte(5);
+        }
+
+        EEPROMWriteQueue<4> queue;
+        const uint8_t data[3] = {1, 2, 3};
+        queue.tryPush(20, data, sizeof(data));
+        queue.drain(chip.eeprom);
+
+        static char text[16384];
+        profiler.dumpFolded(text, sizeof(text), EEPROMCallSiteProfiler::Metric::CALLS);
+        EEPROMSlowOperation slow{};
+        slowLog.tryPop(slow);
+        const EEPROMShadow::Statistics shadow{};
+        formatPrometheus(metrics, &shadow, "check", text, sizeof(text));
+
+        chip.eeprom.removeListener(&metrics);
+        chip.eeprom.removeListener(&slowLog);
+        chip.eeprom.removeListener(&profiler);
+        chip.eeprom.removeListener(&recorder);
+
+        EEPROMTraceReader reader(traceBuffer, recorder.size());
+        replayTrace(reader, chip.eeprom);
+    }
+}
+
+int main()
+{
+    static Chip chip;
+    static Chip other;
+    clockSource = &chip.simulator;
+
+    useDriver(chip, other);
+    useShadow(chip);
+    useHashTree(chip);
+    useLayoutMigration(chip);
+    useRecordsAndPatches(chip);
+    useTimeSeries(chip);
+    useListeners(chip);
+
+    // Сюда доходим, только если ни один вызов не обратился к operator new
+    std::printf("no heap allocations\n");
+    return 0;
+}
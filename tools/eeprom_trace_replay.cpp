@@ -0,0 +1,62 @@
+#include "eeprom_25lc040a.hpp"
+#include "eeprom_25lc040a_simulator.hpp"
+#include "eeprom_trace.hpp"
+#include "spi_bit_banging_helper.hpp"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+/**
+ * @file eeprom_trace_replay.cpp
+ * @brief Утилита воспроизведения трассы на симуляторе 25LC040A.
+ *
+ * Использование:
+ * @code
+ * eeprom_trace_replay <trace.bin>
+ * @endcode
+ *
+ * Выводит число операций, тактов SCLK, кадров, циклов записи,
+ * опросов статуса и модельное время воспроизведения.
+ */
+
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <trace.bin>\n";
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in)
+    {
+        std::cerr << "cannot read trace " << argv[1] << "\n";
+        return 1;
+    }
+    const std::vector<uint8_t> trace((std::istreambuf_iterator<char>(in)),
+                                     std::istreambuf_iterator<char>());
+
+    EEPROMTraceReader reader(trace.data(), trace.size());
+    if (!reader.valid())
+    {
+        std::cerr << "not a trace file: " << argv[1] << "\n";
+        return 1;
+    }
+
+    EEPROM25LC040ASimulator simulator;
+    SPIBitBangingHelper helper(simulator);
+    EEPROM25LC040A eeprom(helper);
+
+    const std::size_t operations = replayTrace(reader, eeprom);
+    const EEPROM25LC040ASimulator::Statistics &stats = simulator.statistics();
+
+    std::cout << "operations   " << operations << "\n"
+              << "clocks       " << stats.clocks << "\n"
+              << "frames       " << stats.frames << "\n"
+              << "write_cycles " << stats.writeCycles << "\n"
+              << "status_polls " << stats.statusPolls << "\n"
+              << "elapsed_us   " << simulator.elapsedNs() / 1000 << "\n";
+
+    return 0;
+}